@@ -0,0 +1,410 @@
+/********************************************************
+** c80.c
+**
+** Host build only: the parts of the Software Toolworks
+** C/80 run time library (and of CP/M) that the utilities
+** use, written on top of the host C library. See c80.h.
+**
+** Channels are small ints as in C/80, 0 meaning failure.
+** Binary reads of a local file are padded with ^Z to a
+** whole 128-byte record, as they would be on CP/M.
+**
+**      18 October 2026
+**
+********************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define MAXCHAN 8
+#define RECSIZE 128
+#define ARENA   (1024L*1024L)
+
+char hostdma[128];
+unsigned short hosttic;
+char *hostckp;
+
+/* SS MM HH DD MM YY, 11 bytes before where hostckp points */
+static char hostclk[17];
+
+static FILE *chans[MAXCHAN];
+static int curdrv;              /* 0 = A: */
+static const char *root;
+
+/* alloc() arena. It is static so that, with -no-pie, all
+** addresses fit in an int the way they do on the 8080.
+*/
+static char arena[ARENA];
+static long arenap;
+
+/* hpath - host path of local file name */
+static char *hpath(const char *name)
+{
+  static char path[1024];
+  int d;
+
+  d = 'A' + curdrv;
+  if ((name[0] != '\0') && (name[1] == ':')) {
+    d = toupper((unsigned char) name[0]);
+    name += 2;
+  }
+  snprintf(path, sizeof(path), "%s/%c/%s", root, d, name);
+  return path;
+}
+
+static FILE *chanf(int chan)
+{
+  return ((chan > 0) && (chan < MAXCHAN)) ? chans[chan] : NULL;
+}
+
+int c80fopen(const char *name, const char *mode)
+{
+  int i;
+  const char *m;
+  FILE *f;
+
+  for (i=1; (i < MAXCHAN) && (chans[i] != NULL); i++)
+    ;
+  if (i == MAXCHAN)
+    return 0;
+  switch (mode[0]) {
+  case 'w':
+    m = "wb";
+    break;
+  case 'u':
+    m = "r+b";
+    break;
+  case 'a':
+    m = "ab";
+    break;
+  default:
+    m = "rb";
+    break;
+  }
+  if ((f = fopen(hpath(name), m)) == NULL)
+    return 0;
+  chans[i] = f;
+  return i;
+}
+
+int c80fclose(int chan)
+{
+  FILE *f;
+
+  if ((f = chanf(chan)) == NULL)
+    return -1;
+  chans[chan] = NULL;
+  return fclose(f);
+}
+
+int c80read(int chan, char *buf, int n)
+{
+  FILE *f;
+  int r;
+
+  if ((f = chanf(chan)) == NULL)
+    return -1;
+  r = fread(buf, 1, n, f);
+  /* CP/M files end on a record boundary */
+  while ((r % RECSIZE) != 0 && (r < n))
+    buf[r++] = 0x1A;
+  return r;
+}
+
+int c80write(int chan, const char *buf, int n)
+{
+  FILE *f;
+
+  if (((f = chanf(chan)) == NULL) || (fwrite(buf, 1, n, f) != (size_t) n))
+    return -1;
+  return n;
+}
+
+/* seek - origins 0, 1, 2 are bytes from the start, the
+** current position and the end; 3, 4, 5 the same in
+** 512-byte blocks.
+*/
+int c80seek(int chan, int off, int origin)
+{
+  FILE *f;
+  long o;
+  static const int whence[3] = { SEEK_SET, SEEK_CUR, SEEK_END };
+
+  if (((f = chanf(chan)) == NULL) || (origin < 0) || (origin > 5))
+    return -1;
+  o = off;
+  if (origin > 2) {
+    o *= 512L;
+    origin -= 3;
+  }
+  return fseek(f, o, whence[origin]);
+}
+
+int c80getc(int chan)
+{
+  FILE *f;
+
+  return ((f = chanf(chan)) == NULL) ? -1 : fgetc(f);
+}
+
+int c80putc(int c, int chan)
+{
+  FILE *f;
+
+  return ((f = chanf(chan)) == NULL) ? -1 : fputc(c, f);
+}
+
+int c80fprintf(int chan, const char *fmt, ...)
+{
+  FILE *f;
+  va_list ap;
+  int r;
+
+  if ((f = chanf(chan)) == NULL)
+    return -1;
+  va_start(ap, fmt);
+  r = vfprintf(f, fmt, ap);
+  va_end(ap);
+  return r;
+}
+
+int c80fscanf(int chan, const char *fmt, ...)
+{
+  FILE *f;
+  va_list ap;
+  int r;
+
+  if ((f = chanf(chan)) == NULL)
+    return -1;
+  va_start(ap, fmt);
+  r = vfscanf(f, fmt, ap);
+  va_end(ap);
+  return r;
+}
+
+/* index - position of t in s, or -1 */
+int c80index(const char *s, const char *t)
+{
+  const char *p;
+
+  return ((p = strstr(s, t)) == NULL) ? -1 : (int) (p - s);
+}
+
+char *c80itoa(int n, char *s)
+{
+  sprintf(s, "%d", n);
+  return s;
+}
+
+/* alloc - nothing is ever given back; the utilities only
+** free everything at the end of a command.
+*/
+char *c80alloc(int n)
+{
+  char *p;
+
+  n = (n + 7) & ~7;
+  if (arenap + n > ARENA)
+    return 0;
+  p = arena + arenap;
+  arenap += n;
+  return p;
+}
+
+int c80free(char *p)
+{
+  return 0;
+}
+
+/* getline - read a console line, return its length */
+int c80getline(char *s, int n)
+{
+  int l;
+
+  if (fgets(s, n, stdin) == NULL) {
+    *s = '\0';
+    return 0;
+  }
+  l = strlen(s);
+  while ((l > 0) && ((s[l-1] == '\n') || (s[l-1] == '\r')))
+    s[--l] = '\0';
+  return l;
+}
+
+/* fcbfld - copy one field of a file name into an FCB,
+** returning a pointer to what follows it.
+*/
+static const char *fcbfld(const char *s, char *f, int n)
+{
+  int i;
+
+  for (i=0; (*s != '\0') && (*s != '.'); s++)
+    if (*s == '*')
+      while (i < n)
+        f[i++] = '?';
+    else if (i < n)
+      f[i++] = toupper((unsigned char) *s);
+  return s;
+}
+
+/* makfcb - build a CP/M FCB from a file name, with "*"
+** expanded to "?".
+*/
+int c80makfcb(const char *name, char *fcb)
+{
+  memset(fcb, 0, 36);
+  memset(fcb+1, ' ', 11);
+  if ((name[0] != '\0') && (name[1] == ':')) {
+    fcb[0] = toupper((unsigned char) name[0]) - 'A' + 1;
+    name += 2;
+  }
+  name = fcbfld(name, fcb+1, 8);
+  if (*name == '.')
+    fcbfld(name+1, fcb+9, 3);
+  return 0;
+}
+
+int CtlCk()
+{
+  return 0;
+}
+
+/* fcbmatch - TRUE if host file name matches FCB pattern */
+static int fcbmatch(const char *fcb, const char *name)
+{
+  char fn[11];
+  int i;
+  const char *dot;
+
+  memset(fn, ' ', 11);
+  dot = strrchr(name, '.');
+  for (i=0; (name[i] != '\0') && (name + i != dot); i++)
+    if (i >= 8)
+      return 0;
+    else
+      fn[i] = name[i];
+  if (dot != NULL)
+    for (i=0; dot[i+1] != '\0'; i++)
+      if (i >= 3)
+        return 0;
+      else
+        fn[8+i] = dot[i+1];
+  for (i=0; i<11; i++)
+    if ((fcb[i+1] != '?') && (fcb[i+1] != fn[i]))
+      return 0;
+  return 1;
+}
+
+/* dirsrch - BDOS 17/18. The match is put in the first
+** entry of the DMA area, returning 0; -1 at the end.
+*/
+static int dirsrch(int first, const char *fcb)
+{
+  static DIR *d;
+  struct dirent *e;
+  struct stat st;
+  char *p;
+  int i;
+  static char dname[300];
+
+  if (first) {
+    if (d != NULL)
+      closedir(d);
+    dname[0] = (fcb[0] == 0) ? 'A' + curdrv : 'A' + fcb[0] - 1;
+    dname[1] = ':';
+    dname[2] = '\0';
+    d = opendir(hpath(dname));
+  }
+  while ((d != NULL) && ((e = readdir(d)) != NULL)) {
+    if ((e->d_name[0] == '.') || !fcbmatch(fcb, e->d_name))
+      continue;
+    strncpy(dname+2, e->d_name, sizeof(dname)-3);
+    if ((stat(hpath(dname), &st) != 0) || !S_ISREG(st.st_mode))
+      continue;
+    memset(hostdma, ' ', 32);
+    hostdma[0] = 0;
+    p = strrchr(e->d_name, '.');
+    for (i=0; (e->d_name + i != p) && (e->d_name[i] != '\0'); i++)
+      hostdma[1+i] = e->d_name[i];
+    if (p != NULL)
+      for (i=0; p[i+1] != '\0'; i++)
+        hostdma[9+i] = p[i+1];
+    return 0;
+  }
+  return -1;
+}
+
+/* bdos - the few BDOS functions the utilities call */
+int c80bdos(int c, ...)
+{
+  va_list ap;
+  int r;
+
+  va_start(ap, c);
+  switch (c) {
+  case 12:
+    /* CP/M 2.2 */
+    r = 0x22;
+    break;
+  case 14:
+    curdrv = va_arg(ap, int) & 0x0F;
+    r = 0;
+    break;
+  case 17:
+  case 18:
+    r = dirsrch(c == 17, va_arg(ap, char *));
+    break;
+  case 25:
+    r = curdrv;
+    break;
+  default:
+    r = 0;
+    break;
+  }
+  va_end(ap);
+  return r;
+}
+
+int c80main();
+
+main(int argc, char *argv[])
+{
+  int i;
+  char *s;
+  char **av;
+  time_t t;
+  struct tm *tm;
+
+  if ((root = getenv("C80ROOT")) == NULL)
+    root = ".";
+
+  /* CP/M 2.2 clock: SS MM HH DD MM YY */
+  time(&t);
+  tm = localtime(&t);
+  hostclk[0] = tm->tm_sec;
+  hostclk[1] = tm->tm_min;
+  hostclk[2] = tm->tm_hour;
+  hostclk[3] = tm->tm_mday;
+  hostclk[4] = tm->tm_mon + 1;
+  hostclk[5] = tm->tm_year % 100;
+  hostckp = hostclk + 11;
+
+  /* the CCP upper cases the command line. Some of the
+  ** utilities also look one past the last argument.
+  */
+  av = (char **) c80alloc((argc + 1) * sizeof(char *));
+  for (i=0; i<argc; i++) {
+    for (s=argv[i]; *s; s++)
+      *s = toupper((unsigned char) *s);
+    av[i] = argv[i];
+  }
+  av[argc] = "";
+  c80main(argc, av);
+  fflush(stdout);
+  return 0;
+}
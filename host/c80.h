@@ -0,0 +1,74 @@
+/********************************************************
+** c80.h
+**
+** Host build only. Included ahead of every C/80 source
+** (gcc -include) so that vinc.c, vutil.c, vpip.c etc.
+** compile unchanged on a Linux or similar build box. It
+** maps the parts of the C/80 run time library the
+** utilities use onto host/c80.c, and makes "unsigned" the
+** 16 bits it is on the 8080.
+**
+** Local drives are directories under $C80ROOT (default
+** the current directory): A:FOO.TXT is $C80ROOT/A/FOO.TXT.
+** The USB drive is provided by the simulator, vsim.c.
+**
+**      18 October 2026
+**
+********************************************************/
+#include <stdio.h>
+
+/* stand-ins for low RAM used by vutil and vpip */
+extern char hostdma[];          /* CP/M DMA area */
+extern unsigned short hosttic;  /* 2ms tick counter */
+extern char *hostckp;           /* CP/M 2.2 clock pointer */
+
+/* C/80 library, see c80.c */
+int c80fopen();
+int c80fclose();
+int c80read();
+int c80write();
+int c80seek();
+int c80getc();
+int c80putc();
+int c80fprintf();
+int c80fscanf();
+int c80index();
+char *c80itoa();
+char *c80alloc();
+int c80free();
+int c80getline();
+int c80makfcb();
+int CtlCk();
+int c80bdos(int c, ...);
+
+/* simulated VDIP1, see vsim.c */
+int inp();
+int outp();
+
+#undef getc
+#undef putc
+#define fopen   c80fopen
+#define fclose  c80fclose
+#define read    c80read
+#define write   c80write
+#define seek    c80seek
+#define getc    c80getc
+#define putc    c80putc
+#define fprintf c80fprintf
+#define fscanf  c80fscanf
+#define index   c80index
+#define itoa    c80itoa
+#define alloc   c80alloc
+#define free    c80free
+#define getline c80getline
+#define makfcb  c80makfcb
+#define bdos    c80bdos
+
+/* the real main() is in c80.c */
+#define main    c80main
+
+/* C/80 ints are 16 bits. Only "unsigned" is changed here:
+** it is what the code uses for 16-bit values that must
+** wrap, e.g. the tick counter and FAT dates.
+*/
+#define unsigned unsigned short
@@ -0,0 +1,44 @@
+/********************************************************
+** crc.c
+**
+** Host build only: C version of the assembly kernel in
+** crc.dri for the vcrc library. The table layout and the
+** running values are the same, so vcrc.c is used as is.
+**
+**      18 October 2026
+**
+********************************************************/
+
+static unsigned char crcarea[6*256];    /* CRC-32 bytes 0..3, CRC-16 hi, lo */
+static unsigned char crcval[6];         /* CRC-32 (4), CRC-16 (2), LSB first */
+
+char *crctab(void)
+{
+  return (char *) crcarea;
+}
+
+char *crcst(void)
+{
+  return (char *) crcval;
+}
+
+void crcupd(const char *buf, int n)
+{
+  const unsigned char *p;
+  unsigned char *c, i;
+  int k;
+
+  c = crcval;
+  for (p=(const unsigned char *) buf, k=n; k > 0; k--) {
+    i = c[0] ^ *p++;
+    c[0] = c[1] ^ crcarea[i];
+    c[1] = c[2] ^ crcarea[i+256];
+    c[2] = c[3] ^ crcarea[i+512];
+    c[3] = crcarea[i+768];
+  }
+  for (p=(const unsigned char *) buf, k=n; k > 0; k--) {
+    i = c[5] ^ *p++;
+    c[5] = c[4] ^ crcarea[i+1024];
+    c[4] = crcarea[i+1280];
+  }
+}
@@ -0,0 +1,3 @@
+/* fprintf.h - host build stand-in for the C/80 header;
+** fprintf() is mapped to the channel version in c80.h.
+*/
@@ -0,0 +1,3 @@
+/* scanf.h - host build stand-in for the C/80 header;
+** fscanf() is mapped to the channel version in c80.h.
+*/
@@ -0,0 +1,394 @@
+/********************************************************
+** simtest - scenarios for the vinc library run against
+** the simulated VDIP1 (vsim.c) in the host build.
+**
+** Usage: simtest {-q}
+**
+**    switches:
+**      -q only report failures, not the timings
+**
+** Each scenario drives the library the way the utilities
+** do, checks what comes back and reports the number of
+** each command issued and the simulated time taken, so
+** that a change to vinc.c (or to the simulated latencies,
+** see vsim.c) can be measured before it is tried on an H8.
+** Scenarios that write use files under SIMTEST on the
+** simulated USB drive. The exit status is 1 if any check
+** fails. devtest() does the same through the vd routines
+** with a struct vdev of its own, and mirtest() writes to
+** the simulated second VDIP1 as well. cachetest() does
+** random record reads and writes through vcache.
+**
+** 18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+
+/* ensure globals live here */
+#define EXTERN
+#include "vutil.h"
+#include "vinc.h"
+#include "vcache.h"
+
+#define TSIZE   32768L  /* bytes per transfer test */
+#define MAXBLK  4096
+#define NDIR    20      /* files in the directory test */
+#define TDIR    "SIMTEST"
+#define MPORT   0271    /* second simulated VDIP1 */
+#define MBLK    256     /* block size of the mirror test */
+#define CREC    100     /* record size of the cache test */
+
+char wbuff[MAXBLK];
+char rbuff[MAXBLK];
+
+int nfail;
+int f_quiet;
+
+/* simulator, see vsim.c */
+int vsimclr();
+int vsimrep();
+
+/* fill - the test pattern for bytes at offset off */
+fill(buf, n, off)
+char *buf;
+int n;
+long off;
+{
+  int i;
+
+  for (i=0; i<n; i++, off++)
+    buf[i] = (off * 7L + (off >> 8)) & 0xFFL;
+}
+
+/* check - count a failure unless ok */
+check(ok, what)
+int ok;
+char *what;
+{
+  if (!ok) {
+    printf("FAILED: %s\n", what);
+    ++nfail;
+  }
+}
+
+/* report - show the figures for a scenario */
+report(title)
+char *title;
+{
+  if (!f_quiet)
+    vsimrep(title);
+}
+
+/* tname - test file name for block size bs */
+char *tname(bs)
+int bs;
+{
+  static char name[13];
+
+  strcpy(name, "BS");
+  itoa(bs, name+2);
+  strcat(name, ".DAT");
+  return name;
+}
+
+/* putfile - write TSIZE bytes in bs-byte WRF commands */
+putfile(bs)
+int bs;
+{
+  long off;
+  char *name;
+  static char title[40];
+
+  name = tname(bs);
+  vsimclr();
+  vdlf(name);
+  check(vwopen(name) == 0, "OPW");
+  for (off=0L; off<TSIZE; off+=bs) {
+    fill(wbuff, bs, off);
+    if (vwrite(wbuff, bs) == -1) {
+      check(FALSE, "WRF");
+      break;
+    }
+  }
+  check(vclose(name) == 0, "CLF after WRF");
+  strcpy(title, "put 32K, WRF ");
+  itoa(bs, title+strlen(title));
+  report(title);
+}
+
+/* getfile - read the file back in bs-byte RDF commands */
+getfile(bs)
+int bs;
+{
+  long off, len;
+  int ok;
+  char *name;
+  static char title[40];
+
+  name = tname(bs);
+  vsimclr();
+  check((vdirf(name, &len) == 0) && (len == TSIZE), "DIR length");
+  check(vropen(name) == 0, "OPR");
+  ok = TRUE;
+  for (off=0L; ok && (off<TSIZE); off+=bs) {
+    fill(wbuff, bs, off);
+    ok = (vread(rbuff, bs) == 0) && (memcmp(rbuff, wbuff, bs) == 0);
+  }
+  check(ok, "RDF data");
+  check(vclf() == 0, "CLF after RDF");
+  strcpy(title, "get 32K, RDF ");
+  itoa(bs, title+strlen(title));
+  report(title);
+}
+
+/* seekfile - random reads of 256 bytes using SEK */
+seekfile()
+{
+  int i, ok;
+  long off;
+
+  vsimclr();
+  check(vropen(tname(1024)) == 0, "OPR");
+  ok = TRUE;
+  for (i=0; ok && (i<32); i++) {
+    off = ((i * 13) % 128) * 256L;
+    fill(wbuff, 256, off);
+    ok = (vseek(off) == 0) && (vread(rbuff, 256) == 0) &&
+         (memcmp(rbuff, wbuff, 256) == 0);
+  }
+  check(ok, "SEK and RDF data");
+  check(vseek(TSIZE + 1L) == -1, "SEK past the end fails");
+  vclf();
+  report("32 x SEK + RDF 256");
+}
+
+/* cachetest - 80 random reads of the first 40 CREC-byte
+** records through vcache, which holds all of them, so
+** each block is fetched once; then records written out
+** of order through the cache and read back with vread().
+*/
+cachetest()
+{
+  int i, n, ok;
+  long off;
+  char *name;
+
+  vsimclr();
+  check(vbopen(tname(1024), "r") == 0, "vbopen");
+  ok = TRUE;
+  for (i=0; ok && (i<80); i++) {
+    off = ((i * 13) % 40) * (long) CREC;
+    fill(wbuff, CREC, off);
+    ok = (vbseek(off) == 0) && (vbread(rbuff, CREC) == CREC) &&
+         (memcmp(rbuff, wbuff, CREC) == 0);
+  }
+  check(ok, "vbread data");
+  check((vbseek(TSIZE - 10L) == 0) && (vbread(rbuff, CREC) == 10),
+    "vbread stops at the end");
+  check(vbseek(TSIZE + 1L) == -1, "vbseek past the end fails");
+  check(vbclose() == 0, "vbclose");
+  report("80 x vbread 100, 8 blocks");
+
+  /* the records in reverse order, each in two pieces */
+  name = "CACHE.DAT";
+  vdlf(name);
+  vsimclr();
+  check(vbopen(name, "w") == 0, "vbopen for write");
+  fill(wbuff, MAXBLK, 0L);
+  ok = TRUE;
+  for (off=(MAXBLK/CREC)*CREC; ok && (off>=0L); off-=CREC) {
+    n = (off + CREC > MAXBLK) ? MAXBLK - (int) off : CREC;
+    ok = (vbseek(off) == 0) && (vbwrite(wbuff+off, 40) == 40) &&
+         (vbwrite(wbuff+off+40, n-40) == n-40);
+  }
+  check(ok && (vbtell() == (long) CREC), "vbwrite");
+  check(vbclose() == 0, "vbclose after vbwrite");
+  report("write 4K in 100-byte records, vbwrite");
+
+  check((vropen(name) == 0) && (vread(rbuff, MAXBLK) == 0) &&
+        (memcmp(rbuff, wbuff, MAXBLK) == 0), "vbwrite data");
+  vclf();
+  vdlf(name);
+}
+
+/* dirtest - make, list, look up and delete NDIR files */
+dirtest()
+{
+  int i, n, type;
+  long len;
+  unsigned d, t;
+  static char name[13];
+  static char names[NDIR][13];
+
+  /* in a directory of their own below TDIR */
+  vsimclr();
+  check(vcd(TDIR) == 0, "CD");
+  if (vcd("LIST") == -1)
+    check((vmkd("LIST") == 0) && (vcd("LIST") == 0), "MKD and CD");
+  for (i=0; i<NDIR; i++) {
+    strcpy(name, "F");
+    itoa(i, name+1);
+    strcat(name, ".TXT");
+    fill(wbuff, 16, (long) i);
+    check((vwopen(name) == 0) && (vwrite(wbuff, 16) == 0) &&
+          (vclose(name) == 0), "small file");
+  }
+  report("write 20 small files");
+
+  /* the listing must be read to the end before the
+  ** next command, as in vsum.
+  */
+  vsimclr();
+  n = 0;
+  vlsopen();
+  while ((type = vlsnext(name)) != -1)
+    if ((type == 0) && (n < NDIR))
+      strcpy(names[n++], name);
+  check(n == NDIR, "DIR listing");
+  for (i=0; i<n; i++) {
+    check((vdirf(names[i], &len) == 0) && (len == 16L), "DIR length");
+    check(vdird(names[i], &d, &t) == 0, "DIRT");
+  }
+  report("list 20 files, DIR and DIRT each");
+
+  vsimclr();
+  for (i=0; i<NDIR; i++) {
+    strcpy(name, "F");
+    itoa(i, name+1);
+    strcat(name, ".TXT");
+    check(vdlf(name) == 0, "DLF");
+  }
+  check(vdlf("F0.TXT") == -1, "DLF of a missing file fails");
+  report("delete 20 files");
+  vcdroot();
+}
+
+/* devtest - the vd routines on a device of our own, with
+** the default device's ports but its own line buffer.
+*/
+devtest()
+{
+  long len;
+  static struct vdev dev;
+  static char line[128];
+
+  vsimclr();
+  vdopen(&dev, p_data, line);
+  check(vdinit(&dev) == 0, "vdinit");
+  check(dev.vd_mode == VDM_ASC, "vdinit sets ASCII mode");
+  check((vdcd(&dev, TDIR) == 0) && (vddirf(&dev, tname(64), &len) == 0) &&
+        (len == TSIZE), "vddirf");
+  check((vdropen(&dev, tname(64)) == 0) && (vdread(&dev, rbuff, 256) == 0) &&
+        (vdclf(&dev) == 0), "vdread");
+  fill(wbuff, 256, 0L);
+  check(memcmp(rbuff, wbuff, 256) == 0, "vdread data");
+  check((dev.vd_nin == 256L) && (dev.vd_ntmo == 0), "device counts");
+  vdcdroot(&dev);
+  report("vd routines on a second handle");
+}
+
+/* mirtest - write the same file to both simulated devices
+** with vdmwrite(), as vput -m does, and read both back. The
+** time can be compared with "put 32K, WRF 256" above.
+*/
+mirtest()
+{
+  long off;
+  int ok;
+  char *name;
+  static struct vdev mdev;
+  static char line[128];
+
+  name = "MIRROR.DAT";
+  vdopen(&mdev, MPORT, line);
+  if (vdinit(&mdev) == -1) {
+    check(FALSE, "vdinit on the second device");
+    return;
+  }
+  vdlf(name);
+  vddlf(&mdev, name);
+
+  vsimclr();
+  check((vwopen(name) == 0) && (vdwopen(&mdev, name) == 0), "OPW on both");
+  ok = TRUE;
+  for (off=0L; ok && (off<TSIZE); off+=MBLK) {
+    fill(wbuff, MBLK, off);
+    ok = (vdmwrite(vddef(), &mdev, wbuff, MBLK) == 0);
+  }
+  check(ok && (vdmwrite(vddef(), &mdev, wbuff, 0) == 0), "vdmwrite");
+  check((vclose(name) == 0) && (vdclose(&mdev, name) == 0), "CLF on both");
+  report("mirror 32K to two devices, WRF 256");
+
+  ok = (vropen(name) == 0) && (vdropen(&mdev, name) == 0);
+  for (off=0L; ok && (off<TSIZE); off+=MBLK) {
+    fill(wbuff, MBLK, off);
+    ok = (vread(rbuff, MBLK) == 0) && (memcmp(rbuff, wbuff, MBLK) == 0) &&
+         (vdread(&mdev, rbuff, MBLK) == 0) && (memcmp(rbuff, wbuff, MBLK) == 0);
+  }
+  check(ok, "mirrored data");
+  vclf();
+  vdclf(&mdev);
+  vdlf(name);
+  vddlf(&mdev, name);
+}
+
+/* errtest - commands that must fail */
+errtest()
+{
+  vsimclr();
+  check(vropen("NOSUCH.DAT") == -1, "OPR of a missing file fails");
+  check(vcd("NOSUCH") == -1, "CD to a missing directory fails");
+  check(vcdup() == -1, "CD .. at the root fails");
+  check(vmkd(TDIR) == -1, "MKD of an existing directory fails");
+  report("errors");
+}
+
+main(argc,argv)
+int argc;
+char *argv[];
+{
+  int bs;
+
+  f_quiet = (argc > 1) && (strcmp(argv[1], "-Q") == 0);
+
+  p_data = VDATA;
+  p_stat = VSTAT;
+  getosver();
+  settd(FALSE);
+
+  vsimclr();
+  if (vinit() == -1) {
+    printf("Error initializing VDIP-1 device!\n");
+    exit(1);
+  }
+  if (vfind_disk() == -1) {
+    printf("No flash drive found!\n");
+    exit(1);
+  }
+  report("vinit, vfind_disk");
+
+  vcdroot();
+  if (vcd(TDIR) == 0)
+    vcdup();
+  else
+    check(vmkd(TDIR) == 0, "MKD");
+  check(vcd(TDIR) == 0, "CD");
+
+  for (bs=64; bs<=MAXBLK; bs*=4) {
+    putfile(bs);
+    getfile(bs);
+  }
+  seekfile();
+  cachetest();
+  mirtest();
+  check(vcdup() == 0, "CD ..");
+  dirtest();
+  devtest();
+  errtest();
+
+  if (nfail > 0) {
+    printf("%d check%s FAILED\n", nfail, (nfail == 1) ? "" : "s");
+    exit(1);
+  }
+  printf("All checks passed\n");
+}
@@ -0,0 +1,680 @@
+/********************************************************
+** vsim.c
+**
+** Host build only: a simulated VDIP1 behind inp() and
+** outp(), so that vinc.c and the utilities built on it can
+** be run, timed and regression tested without an H8.
+**
+** The VNC1L is modelled in ASCII (IPA) mode with the
+** extended command set the library uses: E, IPA, FWV, DIR,
+** DIRT, OPR, OPW, RDF, WRF, SEK, CLF, DLF, CD and MKD, over
+** a directory tree on the host ($VSIM_ROOT, default "usb")
+** standing in for the flash drive. A second VDIP1 at port
+** 0271 has its own tree ($VSIM_ROOT2, default "usb2"), for
+** programs that drive two boards.
+**
+** Time is simulated, not measured. Every inp() or outp()
+** costs "poll" microseconds of 8080 time; each byte takes
+** "byte" microseconds to pass through the FIFO, whose depth
+** is "fifo" bytes in the host-to-device direction (TXE is
+** low while it is full); and each command takes a fixed
+** latency before its reply starts, plus "dirent" per entry
+** listed by DIR. The 2ms tick counter read by timer() and
+** ticks() runs on simulated time, so timeouts and the
+** VSTATS figures behave as on the real machine.
+**
+** The settings are taken from $VSIM as a list of name=value
+** pairs, e.g. VSIM=fifo=128,poll=30,WRF=4000, where a
+** command name sets that command's latency and port and
+** port2 the data ports of the two devices. vsimset() does
+** the same from a program.
+**
+** For each command the simulator counts how often it was
+** issued and the time from the first byte of the command
+** being written to the last byte of its reply being read.
+** vsimrep() prints these with the totals since the last
+** vsimclr(); if $VSIM_REPORT is set a report is printed at
+** exit as well.
+**
+**      18 October 2026
+**
+********************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define VTXE    004
+#define VRXF    010
+
+#define PROMPT  "D:\\>\r"
+#define CFERROR "Command Failed\r"
+#define BCERROR "Bad Command\r"
+
+#define FIFOMAX 4096
+#define LINEMAX 256
+#define PATHMAX 1024
+#define NDEV    2       /* simulated VDIP1s */
+
+typedef long long simt;
+
+extern unsigned short hosttic;
+
+/* command table: name, latency (us), count, time (us) */
+static struct vcmd {
+  const char *name;
+  simt lat;
+  long n;
+  simt t;
+} cmds[] = {
+  { "CR",    200 },     /* empty line, e.g. from vfind_disk() */
+  { "E",     100 },
+  { "IPA",   200 },
+  { "FWV",   500 },
+  { "DIR",   2000 },
+  { "DIRT",  2000 },
+  { "OPR",   5000 },
+  { "OPW",   10000 },
+  { "RDF",   1000 },
+  { "WRF",   2000 },
+  { "SEK",   1500 },
+  { "CLF",   5000 },
+  { "DLF",   8000 },
+  { "CD",    2000 },
+  { "MKD",   10000 },
+  { "other", 200 },
+};
+#define C_CR    0
+#define C_E     1
+#define C_IPA   2
+#define C_FWV   3
+#define C_DIR   4
+#define C_DIRT  5
+#define C_OPR   6
+#define C_OPW   7
+#define C_RDF   8
+#define C_WRF   9
+#define C_SEK   10
+#define C_CLF   11
+#define C_DLF   12
+#define C_CD    13
+#define C_MKD   14
+#define C_OTHER 15
+#define NCMD    16
+
+/* settings */
+static int inited;
+static simt poll_us = 20;       /* 8080 time per port access */
+static simt byte_us = 4;        /* FIFO time per byte */
+static simt dirent_us = 200;    /* DIR time per entry */
+static int fifo = 64;           /* host to device FIFO depth */
+
+/* simulated clock and totals since vsimclr() */
+static simt now;
+static simt t0;
+static long npoll, nover, nbin, nbout;
+
+/* one simulated VDIP1 */
+static struct vsdev {
+  int pdata;                    /* data port, status is pdata+1 */
+  char root[PATHMAX];           /* directory standing in for its drive */
+
+  /* host to device FIFO */
+  unsigned char iq[FIFOMAX];
+  simt iqt[FIFOMAX];
+  int iqh, iqn;
+
+  /* device to host queue: byte and earliest time it can be read */
+  unsigned char *ob;
+  simt *ot;
+  int oh, on, omax;
+  simt olast;                   /* time the last byte read became available */
+
+  /* device */
+  simt dtime;                   /* device busy until */
+  char cline[LINEMAX];
+  int clen;
+  simt cstart;                  /* first byte of the command written */
+  int wleft;                    /* WRF bytes still to come */
+  unsigned char *wbuf;
+  int wlen;
+
+  /* the reply being read: its last byte, command and start */
+  int rend;
+  int rcmd;
+  simt rstart;
+
+  /* open file */
+  FILE *fp;
+  int fmode;                    /* 'r' or 'w' */
+  char fname[PATHMAX];
+
+  /* current directory, relative to root */
+  char cwd[PATHMAX];
+} devs[NDEV] = {
+  { 0261, "usb" },
+  { 0271, "usb2" },
+};
+
+/* the device being served */
+static struct vsdev *dv = devs;
+
+static void vsiminit(void);
+int vsimrep(const char *title);
+
+/* vsimset - apply settings "name=value,..." */
+int vsimset(const char *s)
+{
+  char name[32];
+  long v;
+  int i, n;
+
+  while ((s != NULL) && (*s != '\0')) {
+    if (sscanf(s, "%31[^=,]=%ld%n", name, &v, &n) < 2) {
+      fprintf(stderr, "vsim: bad setting %s\n", s);
+      return -1;
+    }
+    s += n;
+    if (*s == ',')
+      ++s;
+    if (strcmp(name, "poll") == 0)
+      poll_us = (v < 1) ? 1 : (v > 1000) ? 1000 : v;
+    else if (strcmp(name, "byte") == 0)
+      byte_us = v;
+    else if (strcmp(name, "dirent") == 0)
+      dirent_us = v;
+    else if (strcmp(name, "fifo") == 0)
+      fifo = (v < 1) ? 1 : (v > FIFOMAX) ? FIFOMAX : v;
+    else if (strcmp(name, "port") == 0)
+      devs[0].pdata = v;
+    else if (strcmp(name, "port2") == 0)
+      devs[1].pdata = v;
+    else {
+      for (i=0; (i < NCMD) && (strcasecmp(name, cmds[i].name) != 0); i++)
+        ;
+      if (i == NCMD) {
+        fprintf(stderr, "vsim: unknown setting %s\n", name);
+        return -1;
+      }
+      cmds[i].lat = v;
+    }
+  }
+  return 0;
+}
+
+/* vsimclr - start a new scenario */
+int vsimclr(void)
+{
+  int i;
+
+  vsiminit();
+  for (i=0; i<NCMD; i++) {
+    cmds[i].n = 0;
+    cmds[i].t = 0;
+  }
+  npoll = nover = nbin = nbout = 0;
+  t0 = now;
+  return 0;
+}
+
+/* vsimtime - simulated microseconds since vsimclr() */
+long vsimtime(void)
+{
+  return (long) (now - t0);
+}
+
+static void vsimexit(void)
+{
+  vsimrep("total");
+}
+
+static void vsiminit(void)
+{
+  const char *s;
+
+  if (inited)
+    return;
+  inited = 1;
+  devs[0].rend = devs[1].rend = -1;
+  if ((s = getenv("VSIM_ROOT")) != NULL)
+    snprintf(devs[0].root, sizeof(devs[0].root), "%s", s);
+  if ((s = getenv("VSIM_ROOT2")) != NULL)
+    snprintf(devs[1].root, sizeof(devs[1].root), "%s", s);
+  if (vsimset(getenv("VSIM")) == -1)
+    exit(2);
+  if (getenv("VSIM_REPORT") != NULL)
+    atexit(vsimexit);
+}
+
+/* upath - host path of name in the current directory */
+static char *upath(const char *name)
+{
+  static char path[PATHMAX*2];
+
+  if (dv->cwd[0] == '\0')
+    snprintf(path, sizeof(path), "%s/%s", dv->root, name);
+  else
+    snprintf(path, sizeof(path), "%s/%s/%s", dv->root, dv->cwd, name);
+  return path;
+}
+
+/* ufind - look name up in the current directory, ignoring
+** case as FAT does. The host's spelling is left in name.
+** Returns 0 if not found, 'f' for a file, 'd' a directory.
+*/
+static int ufind(char *name)
+{
+  DIR *d;
+  struct dirent *e;
+  struct stat st;
+  int r;
+
+  r = 0;
+  if ((name[0] == '\0') || (strchr(name, '/') != NULL) ||
+      ((d = opendir(upath(""))) == NULL))
+    return 0;
+  while ((e = readdir(d)) != NULL)
+    if ((e->d_name[0] != '.') && (strcasecmp(e->d_name, name) == 0) &&
+        (stat(upath(e->d_name), &st) == 0)) {
+      strcpy(name, e->d_name);
+      r = S_ISDIR(st.st_mode) ? 'd' : 'f';
+      break;
+    }
+  closedir(d);
+  return r;
+}
+
+/* reply - queue bytes for the host from time t on */
+static void reply(const char *s, int n, simt t)
+{
+  int i;
+
+  if (dv->on + n > dv->omax) {
+    dv->omax = (dv->on + n) * 2;
+    dv->ob = realloc(dv->ob, dv->omax);
+    dv->ot = realloc(dv->ot, dv->omax * sizeof(simt));
+  }
+  for (i=0; i<n; i++) {
+    dv->ob[dv->on] = s[i];
+    dv->ot[dv->on++] = t;
+  }
+}
+
+static void replys(const char *s, simt t)
+{
+  reply(s, strlen(s), t);
+}
+
+/* done - end the reply to command c, started by the host at
+** cstart, with s; the device is busy until then.
+*/
+static void done(int c, const char *s, simt t)
+{
+  replys(s, t);
+  if (t > dv->dtime)
+    dv->dtime = t;
+  dv->rend = dv->on - 1;
+  dv->rcmd = c;
+  dv->rstart = dv->cstart;
+}
+
+/* fatdate - FAT time and date of a host time */
+static void fatdate(time_t mt, unsigned *t, unsigned *d)
+{
+  struct tm *tm;
+
+  tm = localtime(&mt);
+  *t = (tm->tm_sec / 2) | (tm->tm_min << 5) | (tm->tm_hour << 11);
+  *d = tm->tm_mday | ((tm->tm_mon + 1) << 5) | ((tm->tm_year - 80) << 9);
+}
+
+static void cmddir(int c, char *arg, simt t)
+{
+  DIR *d;
+  struct dirent *e;
+  struct stat st;
+  char line[LINEMAX+64];
+  int n;
+  unsigned ft, fd;
+
+  replys("\r", t);
+  if (arg[0] == '\0') {
+    /* list the whole directory */
+    n = 0;
+    if ((d = opendir(upath(""))) != NULL) {
+      while ((e = readdir(d)) != NULL) {
+        if ((e->d_name[0] == '.') || (stat(upath(e->d_name), &st) != 0))
+          continue;
+        snprintf(line, sizeof(line), S_ISDIR(st.st_mode) ? "%s DIR\r" :
+          "%s\r", e->d_name);
+        replys(line, t + (++n) * dirent_us);
+      }
+      closedir(d);
+    }
+    done(c, PROMPT, t + n * dirent_us);
+    return;
+  }
+  if ((ufind(arg) != 'f') || (stat(upath(arg), &st) != 0)) {
+    done(c, CFERROR, t);
+    return;
+  }
+  if (c == C_DIR) {
+    /* DIR: length as 4 bytes, LSB first */
+    snprintf(line, sizeof(line), "%s $%02X $%02X $%02X $%02X\r", arg,
+      (int) (st.st_size & 0xFF), (int) ((st.st_size >> 8) & 0xFF),
+      (int) ((st.st_size >> 16) & 0xFF), (int) ((st.st_size >> 24) & 0xFF));
+  }
+  else {
+    /* DIRT: created, accessed (date only) and modified,
+    ** all given as the host's modification time.
+    */
+    fatdate(st.st_mtime, &ft, &fd);
+    snprintf(line, sizeof(line), "%s $%02X $%02X $%02X $%02X $%02X $%02X "
+      "$%02X $%02X $%02X $%02X\r", arg, ft & 0xFF, ft >> 8, fd & 0xFF,
+      fd >> 8, fd & 0xFF, fd >> 8, ft & 0xFF, ft >> 8, fd & 0xFF, fd >> 8);
+  }
+  replys(line, t);
+  done(c, PROMPT, t);
+}
+
+/* fclean - close the open file, if any */
+static void fclean(void)
+{
+  if (dv->fp != NULL)
+    fclose(dv->fp);
+  dv->fp = NULL;
+  dv->fmode = 0;
+}
+
+/* command - carry out the command line in cline */
+static void command(void)
+{
+  char *arg, *s;
+  char name[PATHMAX];
+  char *buf;
+  int c, k;
+  long v;
+  simt t;
+  struct stat st;
+
+  /* split off the first word and look it up */
+  for (arg=dv->cline; (*arg != '\0') && (*arg != ' '); arg++)
+    *arg = toupper((unsigned char) *arg);
+  if (*arg == ' ')
+    *arg++ = '\0';
+  if (dv->cline[0] == '\0')
+    c = C_CR;
+  else
+    for (c=1; (c < C_OTHER) && (strcmp(dv->cline, cmds[c].name) != 0); c++)
+      ;
+  ++cmds[c].n;
+  t = dv->dtime + cmds[c].lat;
+
+  /* first argument as a file name; the OPW and MKD date
+  ** that may follow is ignored.
+  */
+  snprintf(name, sizeof(name), "%s", arg);
+  if ((s = strchr(name, ' ')) != NULL)
+    *s = '\0';
+  v = atol(arg);
+
+  switch (c) {
+  case C_CR:
+  case C_IPA:
+    done(c, PROMPT, t);
+    break;
+  case C_E:
+    done(c, "E\r", t);
+    break;
+  case C_FWV:
+    replys("\rMAIN 03.69-VSIM\rRPRG 1.00R\r", t);
+    done(c, PROMPT, t);
+    break;
+  case C_DIR:
+  case C_DIRT:
+    cmddir(c, name, t);
+    break;
+  case C_OPR:
+  case C_OPW:
+    fclean();
+    k = ufind(name);
+    if (k == 'd')
+      dv->fp = NULL;
+    else if (c == C_OPR)
+      dv->fp = k ? fopen(upath(name), "rb") : NULL;
+    else if (k)
+      dv->fp = fopen(upath(name), "r+b");
+    else {
+      for (s=name; *s; s++)
+        *s = toupper((unsigned char) *s);
+      dv->fp = fopen(upath(name), "w+b");
+    }
+    if (dv->fp == NULL)
+      done(c, CFERROR, t);
+    else {
+      dv->fmode = (c == C_OPR) ? 'r' : 'w';
+      strcpy(dv->fname, name);
+      /* OPW appends to an existing file */
+      if (dv->fmode == 'w')
+        fseek(dv->fp, 0L, SEEK_END);
+      done(c, PROMPT, t);
+    }
+    break;
+  case C_RDF:
+    if ((dv->fmode != 'r') || (v < 1)) {
+      done(c, CFERROR, t);
+      break;
+    }
+    buf = calloc(v, 1);
+    fread(buf, 1, v, dv->fp);
+    reply(buf, v, t);
+    free(buf);
+    nbout += v;
+    done(c, PROMPT, t + v * byte_us);
+    break;
+  case C_WRF:
+    if ((dv->fmode != 'w') || (v < 1)) {
+      done(c, CFERROR, t);
+      break;
+    }
+    /* the prompt follows the data, see devbyte() */
+    dv->wbuf = realloc(dv->wbuf, v);
+    dv->wleft = v;
+    dv->wlen = 0;
+    break;
+  case C_SEK:
+    if ((dv->fp == NULL) || (fstat(fileno(dv->fp), &st) != 0) || (v > st.st_size))
+      done(c, CFERROR, t);
+    else {
+      fseek(dv->fp, v, SEEK_SET);
+      done(c, PROMPT, t);
+    }
+    break;
+  case C_CLF:
+    fclean();
+    done(c, PROMPT, t);
+    break;
+  case C_DLF:
+    if ((ufind(name) != 'f') || ((dv->fp != NULL) &&
+        (strcmp(name, dv->fname) == 0)) || (unlink(upath(name)) != 0))
+      done(c, CFERROR, t);
+    else
+      done(c, PROMPT, t);
+    break;
+  case C_CD:
+    if (strcmp(name, "..") == 0) {
+      if (dv->cwd[0] == '\0')
+        done(c, CFERROR, t);
+      else {
+        if ((s = strrchr(dv->cwd, '/')) != NULL)
+          *s = '\0';
+        else
+          dv->cwd[0] = '\0';
+        done(c, PROMPT, t);
+      }
+    }
+    else if ((ufind(name) != 'd') ||
+             (strlen(dv->cwd) + strlen(name) + 2 > sizeof(dv->cwd)))
+      done(c, CFERROR, t);
+    else {
+      if (dv->cwd[0] != '\0')
+        strcat(dv->cwd, "/");
+      strcat(dv->cwd, name);
+      done(c, PROMPT, t);
+    }
+    break;
+  case C_MKD:
+    for (s=name; *s; s++)
+      *s = toupper((unsigned char) *s);
+    if ((name[0] == '\0') || ufind(name) || (mkdir(upath(name), 0777) != 0))
+      done(c, CFERROR, t);
+    else
+      done(c, PROMPT, t);
+    break;
+  default:
+    done(c, BCERROR, t);
+    break;
+  }
+}
+
+/* devbyte - the device takes a byte from the FIFO */
+static void devbyte(int b, simt arrived)
+{
+  if (dv->wleft > 0) {
+    /* WRF data */
+    dv->wbuf[dv->wlen++] = b;
+    if (--dv->wleft == 0) {
+      fwrite(dv->wbuf, 1, dv->wlen, dv->fp);
+      fflush(dv->fp);
+      nbin += dv->wlen;
+      done(C_WRF, PROMPT, dv->dtime + cmds[C_WRF].lat);
+    }
+  }
+  else {
+    if (dv->clen == 0)
+      dv->cstart = arrived;
+    if (b == '\r') {
+      dv->cline[dv->clen] = '\0';
+      dv->clen = 0;
+      command();
+    }
+    else if (dv->clen < LINEMAX - 1)
+      dv->cline[dv->clen++] = b;
+  }
+}
+
+/* drain - let the device catch up with simulated time */
+static void drain(void)
+{
+  simt t;
+
+  while (dv->iqn > 0) {
+    t = ((dv->dtime > dv->iqt[dv->iqh]) ? dv->dtime : dv->iqt[dv->iqh]) + byte_us;
+    if (t > now)
+      break;
+    dv->dtime = t;
+    devbyte(dv->iq[dv->iqh], dv->iqt[dv->iqh]);
+    dv->iqh = (dv->iqh + 1) % FIFOMAX;
+    --dv->iqn;
+  }
+}
+
+/* avail - time the next byte for the host can be read */
+static simt avail(void)
+{
+  simt t;
+
+  t = dv->olast + byte_us;
+  return (dv->ot[dv->oh] > t) ? dv->ot[dv->oh] : t;
+}
+
+/* tick - one port access worth of 8080 time, during which
+** every device carries on. Returns the device at port (its
+** data or status port), or NULL if there is none.
+*/
+static struct vsdev *tick(int port)
+{
+  struct vsdev *d;
+
+  vsiminit();
+  now += poll_us;
+  hosttic = (unsigned short) (now / 2000);
+  d = NULL;
+  for (dv=devs; dv < devs + NDEV; dv++) {
+    drain();
+    if ((port == dv->pdata) || (port == dv->pdata + 1))
+      d = dv;
+  }
+  return dv = d;
+}
+
+int inp(int port)
+{
+  int b;
+
+  if (tick(port) == NULL)
+    return 0;
+  if (port != dv->pdata) {
+    /* status */
+    ++npoll;
+    b = 0;
+    if (dv->iqn < fifo)
+      b |= VTXE;
+    if ((dv->oh < dv->on) && (avail() <= now))
+      b |= VRXF;
+    return b;
+  }
+  if ((dv->oh >= dv->on) || (avail() > now))
+    return 0;
+  dv->olast = avail();
+  b = dv->ob[dv->oh];
+  if (dv->oh == dv->rend) {
+    /* whole reply read */
+    cmds[dv->rcmd].t += now - dv->rstart;
+    dv->rend = -1;
+  }
+  if (++dv->oh == dv->on)
+    dv->oh = dv->on = 0;
+  return b;
+}
+
+int outp(int port, int b)
+{
+  if ((tick(port) == NULL) || (port != dv->pdata))
+    return 0;
+  if (dv->iqn >= fifo) {
+    ++nover;
+    return 0;
+  }
+  dv->iq[(dv->iqh + dv->iqn) % FIFOMAX] = b;
+  dv->iqt[(dv->iqh + dv->iqn) % FIFOMAX] = now;
+  ++dv->iqn;
+  return 0;
+}
+
+/* vsimrep - show the figures since vsimclr() */
+int vsimrep(const char *title)
+{
+  int i;
+  long n;
+
+  n = 0;
+  for (i=0; i<NCMD; i++)
+    n += cmds[i].n;
+  printf("-- %s: %.3f ms simulated, %ld commands\n", title,
+    (now - t0) / 1000.0, n);
+  printf("   %ld status polls, %ld bytes written, %ld read", npoll,
+    nbin, nbout);
+  if (nover > 0)
+    printf(", %ld bytes lost to a full FIFO", nover);
+  printf("\n");
+  for (i=0; i<NCMD; i++)
+    if (cmds[i].n > 0)
+      printf("   %-5s %6ld %12.3f ms %9.3f ms each\n", cmds[i].name,
+        cmds[i].n, cmds[i].t / 1000.0, cmds[i].t / 1000.0 / cmds[i].n);
+  return 0;
+}
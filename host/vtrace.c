@@ -0,0 +1,259 @@
+/********************************************************
+** vtrace.c
+**
+** Host side analyser for the protocol traces written by a
+** vinc library built with VTRACE (see vtrdump() in vinc.c).
+**
+** Usage: vtrace {-v} file
+**
+**    -v list every command, not just the summary
+**
+** The trace is split into commands: each starts at the
+** library's command mark, or failing that at the first
+** byte sent after a reply, and ends at the prompt mark.
+** For each the analyser finds
+**
+**    gap    time since the previous command ended, i.e.
+**           time spent in the program between commands
+**    send   first to last byte sent (command and WRF data)
+**    turn   last byte sent to first byte of the reply, the
+**           time the VNC1L took to act on the command
+**    total  start to end of the command
+**
+** and summarises them by command name. Times are in ms at
+** the resolution of the clock the trace was made with:
+** 2ms ticks, or whole seconds on CP/M 3 and MP/M.
+**
+**      18 October 2026
+**
+********************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define VTRHDR  16
+#define MAXNAME 10
+#define MAXCMDS 64
+
+/* one command reconstructed from the trace */
+struct tcmd {
+  char text[64];
+  int tlen;
+  int done;             /* whole command line seen */
+  double start, lastout, firstin, lastin, end;
+  long nout, nin;
+  int tmo;
+};
+
+/* totals for one command name */
+struct tsum {
+  char name[MAXNAME+1];
+  long n, nout, nin, tmo;
+  double gap, send, turn, total, max;
+};
+
+static struct tsum sums[MAXCMDS];
+static int nsums;
+static int verbose;
+static double lastend = -1;
+
+static const char *clsname[] = {
+  "RDF", "WRF", "OPR/OPW", "SEK", "CLF", "DIR", "other"
+};
+
+/* cmdname - first word of the command, upper case */
+static void cmdname(const struct tcmd *c, char *name)
+{
+  int i;
+
+  for (i=0; (i < MAXNAME) && (i < c->tlen) && (c->text[i] != ' '); i++)
+    name[i] = toupper((unsigned char) c->text[i]);
+  name[i] = '\0';
+  if (i == 0)
+    /* a class name or "(partial)" if nothing was sent */
+    strncpy(name, (c->text[0] != '\0') ? c->text : "(CR)", MAXNAME);
+  name[MAXNAME] = '\0';
+}
+
+/* finish - account for a command once it has ended */
+static void finish(struct tcmd *c)
+{
+  struct tsum *s;
+  char name[MAXNAME+1];
+  double gap, send, turn, total;
+  int i;
+
+  if ((c->nout == 0) && (c->nin == 0))
+    return;
+  if (c->end < 0)
+    c->end = (c->lastin >= 0) ? c->lastin : c->lastout;
+  cmdname(c, name);
+  gap = (lastend >= 0) ? c->start - lastend : 0;
+  send = (c->lastout >= 0) ? c->lastout - c->start : 0;
+  turn = ((c->firstin >= 0) && (c->lastout >= 0)) ? c->firstin - c->lastout : 0;
+  total = c->end - c->start;
+  lastend = c->end;
+
+  if (verbose)
+    printf("%10.0f %7.0f %7.0f %7.0f %7.0f  %-30.30s %6ld %6ld%s\n",
+      c->start, gap, send, turn, total, c->text, c->nout, c->nin,
+      c->tmo ? " timeout" : "");
+
+  for (i=0; (i < nsums) && (strcmp(sums[i].name, name) != 0); i++)
+    ;
+  if (i == nsums) {
+    if (nsums == MAXCMDS)
+      return;
+    strcpy(sums[nsums++].name, name);
+  }
+  s = &sums[i];
+  ++s->n;
+  s->nout += c->nout;
+  s->nin += c->nin;
+  s->tmo += c->tmo;
+  s->gap += gap;
+  s->send += send;
+  s->turn += turn;
+  s->total += total;
+  if (total > s->max)
+    s->max = total;
+}
+
+static void begin(struct tcmd *c, double t)
+{
+  memset(c, 0, sizeof(*c));
+  c->start = t;
+  c->lastout = c->firstin = c->lastin = c->end = -1;
+}
+
+int main(int argc, char *argv[])
+{
+  FILE *f;
+  unsigned char hdr[VTRHDR], ev[4];
+  unsigned hz, nev, tick, last;
+  long i;
+  double ticks, ms;
+  int open, synced, a;
+  struct tcmd cur;
+  struct tsum *s;
+
+  for (a=1; (a < argc) && (argv[a][0] == '-'); a++)
+    if (strcmp(argv[a], "-v") == 0)
+      verbose = 1;
+  if (a != argc - 1) {
+    fprintf(stderr, "Usage: vtrace {-v} file\n");
+    return 2;
+  }
+  if ((f = fopen(argv[a], "rb")) == NULL) {
+    perror(argv[a]);
+    return 1;
+  }
+  if ((fread(hdr, 1, VTRHDR, f) != VTRHDR) || (memcmp(hdr, "VTRACE", 6) != 0)) {
+    fprintf(stderr, "%s: not a VTRACE dump\n", argv[a]);
+    return 1;
+  }
+  hz = hdr[6] | (hdr[7] << 8);
+  nev = hdr[8] | (hdr[9] << 8);
+  if (hz == 0)
+    hz = 500;
+  ms = 1000.0 / hz;
+  printf("%u events, clock %u ticks per second\n", nev, hz);
+  if (verbose)
+    printf("\n  start ms  gap ms send ms turn ms  tot ms  command"
+      "                          out     in\n");
+
+  /* the clock wraps at 65536 ticks (60 for the seconds
+  ** clock); events are assumed to be less apart than that.
+  */
+  ticks = 0;
+  last = 0;
+  open = 0;
+  synced = 0;
+  memset(&cur, 0, sizeof(cur));
+  for (i=0; (i < nev) && (fread(ev, 1, 4, f) == 4); i++) {
+    tick = ev[2] | (ev[3] << 8);
+    if (i > 0)
+      ticks += (hz == 1) ? (tick + 60 - last) % 60 : (tick - last) & 0xFFFF;
+    last = tick;
+    switch (ev[0]) {
+    case 'C':
+      synced = 1;
+      if (open)
+        finish(&cur);
+      begin(&cur, ticks * ms);
+      if (ev[1] < 7) {
+        /* named by class until the command is seen */
+        strcpy(cur.text, clsname[ev[1]]);
+        cur.tlen = 0;
+      }
+      open = 1;
+      break;
+    case 'O':
+      /* output after a reply with no mark starts a command */
+      if (open && (cur.nin > 0)) {
+        finish(&cur);
+        open = 0;
+      }
+      if (!open) {
+        begin(&cur, ticks * ms);
+        open = 1;
+      }
+      if (!synced && !cur.done) {
+        /* the ring wrapped in the middle of a command */
+        strcpy(cur.text, "(partial)");
+        cur.done = 1;
+      }
+      ++cur.nout;
+      cur.lastout = ticks * ms;
+      if (!cur.done) {
+        if (ev[1] == '\r')
+          cur.done = 1;
+        else if (cur.tlen < (int) sizeof(cur.text) - 1) {
+          cur.text[cur.tlen++] = isprint(ev[1]) ? ev[1] : '.';
+          cur.text[cur.tlen] = '\0';
+        }
+      }
+      break;
+    case 'I':
+      if (!open) {
+        /* the trace started in the middle of a reply */
+        begin(&cur, ticks * ms);
+        strcpy(cur.text, "(partial)");
+        open = 1;
+      }
+      ++cur.nin;
+      if (cur.firstin < 0)
+        cur.firstin = ticks * ms;
+      cur.lastin = ticks * ms;
+      break;
+    case 'E':
+      synced = 1;
+      if (open) {
+        cur.end = ticks * ms;
+        finish(&cur);
+        open = 0;
+      }
+      break;
+    case 'T':
+      if (open)
+        cur.tmo = 1;
+      break;
+    }
+  }
+  if (open)
+    finish(&cur);
+  fclose(f);
+
+  printf("\ncommand       count  avg gap avg send avg turn avg total  max total"
+    "   bytes out    bytes in\n");
+  for (s=sums; s < sums + nsums; s++) {
+    printf("%-10s %8ld %8.1f %8.1f %8.1f %9.1f %10.1f %11ld %11ld", s->name,
+      s->n, s->gap / s->n, s->send / s->n, s->turn / s->n, s->total / s->n,
+      s->max, s->nout, s->nin);
+    if (s->tmo > 0)
+      printf("  %ld timeouts", s->tmo);
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,468 @@
+/********************************************************
+** vbench - Version 4.3 for CP/M and HDOS
+**
+** This program measures the speed of the link to the VDIP
+** device and the flash drive, so that buffer sizes, modes
+** and timeouts can be compared by measurement rather than
+** by guesswork.
+**
+** Usage: vbench {-c} {-fname} {-lname} {-knn} {-pxxx}
+**
+**    switches:
+**      -c append the results to VBENCH.CSV on the USB drive
+**      -fname append the results to CSV file 'name' instead
+**      -lname label for this machine in the CSV file (the
+**         default is the operating system and version, e.g.
+**         CPM22)
+**      -knn to move nn KB in each throughput test (1 to
+**         511, default 8)
+**      -pxxx to specify octal port (default is 0261)
+**
+** The tests are:
+**
+**    HANDSHAKE  round trip of the "E" echo used by vsync()
+**    OPW, CLF   opening a file for write, and closing it
+**    FIFO WR    bytes written to the VDIP FIFO during a WRF,
+**    FIFO RD    or read from it during an RDF, timing only
+**               the byte loop (no command or prompt)
+**    WRF, RDF   whole vwrite() and vread() calls with block
+**               sizes from 16 bytes to 4 KB
+**
+** A scratch file (VBENCH.TMP) is written on the USB drive
+** and deleted afterwards. Each row of the CSV file gives the
+** label, the firmware version reported by the VNC1L, the
+** test, block size, count, time per operation and bytes per
+** second, so results from several machines and firmware
+** versions can be gathered in one place.
+**
+** Times come from ticks(): 2 ms under HDOS and CP/M 2.2 but
+** only one second under CP/M 3 and MP/M, where a larger -k
+** gives more useful throughput figures.
+**
+** Compiled with Software Toolworks C/80 V. 3.1 with support for
+** floats and longs.  Typical link statement:
+**
+** L80 vbench,vfile,vinc,vutil,pio,fprintf,seek,flibrary/s,stdlib/s,clibrary/s,vbench/n/e
+**
+** Our convention is to save all files with CP/M style
+** line endings (CR-LF). The HDOS version of C/80 is picky
+** and wants to see just LF (which is the HDOS standard line ending,
+** therefore the CR characters must be stripped out before compilation.
+** A separate STRIP.C program provides this capability.
+**
+** 18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+
+/* ensure globals live here */
+#define EXTERN
+#include "vutil.h"
+#include "vinc.h"
+#include "vfile.h"
+
+#define FSLEN   20
+#define TMPFILE "VBENCH.TMP"
+#define CSVFILE "VBENCH.CSV"
+#define MINBLK  16      /* smallest WRF/RDF block */
+#define MAXBLK  4096    /* largest WRF/RDF block */
+#define NREP    20      /* repeats of the latency tests */
+#define MAXRES  20      /* most results kept */
+#define MAXKB   511     /* largest -k; MINBLK blocks fit an int */
+
+/* one measurement */
+struct bres {
+  char rname[12];       /* test */
+  int rsize;            /* block size, 0 if none */
+  int rcount;           /* operations timed */
+  long rticks;          /* total time */
+  long rbytes;          /* data moved, 0 for latency tests */
+};
+
+struct bres res[MAXRES];
+int nres;
+
+char *buf;              /* data block */
+long tsize;             /* bytes moved per throughput test */
+char fwver[40];         /* VNC1L firmware version */
+
+/* switches */
+int f_csv;
+char csvname[FSLEN];
+char label[FSLEN];
+
+/* dosw - process any switches on the command line.
+** Switches are preceded by "-".  If a numeric value
+** is given there should be no space, for example:
+** -p261 specifies port 261.
+*/
+dosw(argc, argv)
+int argc;
+char *argv[];
+{
+  int i;
+  char *s;
+
+  strcpy(csvname, CSVFILE);
+  tsize = 8192L;
+
+  /* process right to left */
+  for (i=argc-1; i>0; i--) {
+    s = argv[i];
+    if (*s++ == '-') {
+      /* have a switch! */
+      switch (*s) {
+      case 'C':
+        f_csv = TRUE;
+        break;
+      case 'F':
+        f_csv = TRUE;
+        strncpy(csvname, s+1, 12);
+        csvname[12] = NUL;
+        break;
+      case 'L':
+        strncpy(label, s+1, FSLEN-1);
+        break;
+      case 'K':
+        tsize = dectol(s+1);
+        if ((tsize < 1L) || (tsize > MAXKB)) {
+          printf("-k must be 1 to %d, using 8\n", MAXKB);
+          tsize = 8L;
+        }
+        tsize *= 1024L;
+        break;
+      case 'P':
+        ++s;
+        p_data = aotoi(s);
+        p_stat = p_data + 1;
+          break;
+      default:
+          printf("Invalid switch %c\n", *s);
+        break;
+      }
+    }
+  }
+}
+
+/* addres - save a measurement */
+addres(name, size, count, t, bytes)
+char *name;
+int size, count;
+long t, bytes;
+{
+  struct bres *r;
+
+  if (nres >= MAXRES)
+    return;
+  r = &res[nres++];
+  strcpy(r->rname, name);
+  r->rsize = size;
+  r->rcount = count;
+  r->rticks = t;
+  r->rbytes = bytes;
+}
+
+/* msop - format the time per operation of r in s (ms,
+** to a tenth)
+*/
+char *msop(r, s)
+struct bres *r;
+char *s;
+{
+  return ltotenth(r->rticks * 10000L / tickhz() / r->rcount, s);
+}
+
+/* rate - format the bytes per second of r in s */
+char *rate(r, s)
+struct bres *r;
+char *s;
+{
+  if ((r->rbytes == 0L) || (r->rticks == 0L))
+    strcpy(s, "-");
+  else
+    ltodec(r->rbytes * tickhz() / r->rticks, s);
+  return s;
+}
+
+/* getfwv - ask the VNC1L for its firmware version. The
+** reply is a line for each part of the firmware, e.g.
+** "MAIN 03.69VDAPF", then the prompt; the first is kept.
+*/
+getfwv()
+{
+  strcpy(fwver, "unknown");
+  str_send("fwv\r");
+  while ((str_rdw(linebuff, '\r') != -1) && (strcmp(linebuff, PROMPT) != 0))
+    if ((linebuff[0] != NUL) && (strcmp(fwver, "unknown") == 0))
+      strncpy(fwver, linebuff, 39);
+}
+
+/* cmd - send a command and wait for the prompt */
+int cmd(s)
+char *s;
+{
+  str_send(s);
+  str_send("\r");
+  return vprompt();
+}
+
+/* latency - time the handshake and the OPW and CLF
+** commands. Returns -1 on error.
+*/
+int latency()
+{
+  int i;
+  long t, t1, topw, tclf;
+  static char opw[40];
+
+  t = ticks();
+  for (i=0; i<NREP; i++)
+    if (vhandshake() == -1)
+      return -1;
+  addres("HANDSHAKE", 0, NREP, ticks() - t, 0L);
+
+  /* the file is opened and closed directly, since
+  ** vwopen() also closes any open file first.
+  */
+  settd(FALSE);
+  strcpy(opw, "opw ");
+  strcat(opw, TMPFILE);
+  strcat(opw, td_string);
+  topw = tclf = 0L;
+  for (i=0; i<NREP; i++) {
+    t = ticks();
+    if (cmd(opw) == -1)
+      return -1;
+    t1 = ticks();
+    if (cmd("clf") == -1)
+      return -1;
+    topw += t1 - t;
+    tclf += ticks() - t1;
+  }
+  addres("OPW", 0, NREP, topw, 0L);
+  addres("CLF", 0, NREP, tclf, 0L);
+  return 0;
+}
+
+/* fifo - time just the byte loops of a WRF and an RDF
+** of n bytes. Returns -1 on error.
+*/
+int fifo(n)
+int n;
+{
+  int i;
+  long t;
+  char *p;
+  static char num[7];
+
+  vdlf(TMPFILE);
+  if (vwopen(TMPFILE) == -1)
+    return -1;
+  str_send("wrf ");
+  str_send(itoa(n, num));
+  str_send("\r");
+  t = ticks();
+  for (i=0, p=buf; i<n; i++)
+    out_v(*p++);
+  t = ticks() - t;
+  if ((vprompt() == -1) || (vclose(TMPFILE) == -1))
+    return -1;
+  addres("FIFO WR", n, 1, t, (long) n);
+
+  if (vropen(TMPFILE) == -1)
+    return -1;
+  str_send("rdf ");
+  str_send(itoa(n, num));
+  str_send("\r");
+  t = ticks();
+  for (i=0, p=buf; i<n; i++) {
+    while ((inp(p_stat) & VRXF) == 0)
+      ;
+    *p++ = inp(p_data);
+  }
+  t = ticks() - t;
+  if ((vprompt() == -1) || (vclose(TMPFILE) == -1))
+    return -1;
+  addres("FIFO RD", n, 1, t, (long) n);
+  return 0;
+}
+
+/* blocks - time vwrite() then vread() of the scratch
+** file in blocks of bs bytes. Returns -1 on error.
+*/
+int blocks(bs)
+int bs;
+{
+  int i, n;
+  long t;
+
+  if ((n = (int) (tsize / bs)) < 1)
+    n = 1;
+
+  vdlf(TMPFILE);
+  if (vwopen(TMPFILE) == -1)
+    return -1;
+  t = ticks();
+  for (i=0; i<n; i++) {
+#ifndef HDOS
+    /* check for ^C */
+    CtlCk();
+#endif
+    if (vwrite(buf, bs) == -1)
+      return -1;
+  }
+  t = ticks() - t;
+  vclose(TMPFILE);
+  addres("WRF", bs, n, t, (long) n * bs);
+
+  if (vropen(TMPFILE) == -1)
+    return -1;
+  t = ticks();
+  for (i=0; i<n; i++) {
+#ifndef HDOS
+    /* check for ^C */
+    CtlCk();
+#endif
+    if (vread(buf, bs) == -1)
+      return -1;
+  }
+  t = ticks() - t;
+  vclose(TMPFILE);
+  addres("RDF", bs, n, t, (long) n * bs);
+  return 0;
+}
+
+/* bench - run all the tests. Returns -1 on error. */
+int bench()
+{
+  int i, bs;
+
+  for (i=0; i<MAXBLK; i++)
+    buf[i] = i;
+
+  getfwv();
+  printf("Firmware %s, %s KB per test\n", fwver, ltodec(tsize / 1024L, linebuff));
+
+  if ((latency() == -1) || (fifo(MAXBLK) == -1))
+    return -1;
+  for (bs=MINBLK; bs<=MAXBLK; bs <<= 2)
+    if (blocks(bs) == -1)
+      return -1;
+  vdlf(TMPFILE);
+  return 0;
+}
+
+/* showres - print the results as a table */
+showres()
+{
+  int i;
+  struct bres *r;
+  static char s1[15], s2[15];
+
+  printf("\nTest        Block  Count      ms/op     bytes/s\n");
+  for (i=0; i<nres; i++) {
+    r = &res[i];
+    printf("%-10s  %5d  %5d  %9s  %10s\n", r->rname, r->rsize, r->rcount,
+      msop(r, s1), rate(r, s2));
+  }
+}
+
+/* putcsv - append the results to the CSV file on the USB
+** drive, with a heading line if the file is new. Returns
+** -1 on error.
+*/
+int putcsv()
+{
+  struct vfile *f;
+  int i, isnew;
+  long len;
+  struct bres *r;
+  static char s[15];
+
+  isnew = (vdirf(csvname, &len) == -1);
+  settd(FALSE);
+  if ((f = vfopen(csvname, "a")) == 0)
+    return -1;
+  if (isnew)
+    vfputs("label,firmware,test,block,count,ms/op,bytes/s\r\n", f);
+  for (i=0; i<nres; i++) {
+    r = &res[i];
+    vfputs(label, f);
+    vputc(',', f);
+    vfputs(fwver, f);
+    vputc(',', f);
+    vfputs(r->rname, f);
+    vputc(',', f);
+    vfputs(itoa(r->rsize, s), f);
+    vputc(',', f);
+    vfputs(itoa(r->rcount, s), f);
+    vputc(',', f);
+    vfputs(msop(r, s), f);
+    vputc(',', f);
+    vfputs(rate(r, s), f);
+    vfputs("\r\n", f);
+  }
+  return vfclose(f);
+}
+
+main(argc,argv)
+int argc;
+char *argv[];
+{
+  int userport;
+
+  printf("VBENCH v%s, ", VERSION);
+
+  /* Set default values */
+  p_data = VDATA;
+  p_stat = VSTAT;
+
+  /* set globals 'os' and 'osver' */
+  getosver();
+
+	/* check if user has a file specifying the port. For
+	** HDOS we can provide the location of this program executable
+	** but for CP/M we can only suggest looking on A:
+	*/
+#ifdef HDOS
+	userport = chkport("SY0:");
+#else
+	userport = chkport("A:");
+#endif
+
+  /* process any switches and set defaults */
+  dosw(argc, argv);
+
+  printf("using %s port: [%o]\n", (userport ? "user-specified" : "default"), p_data);
+
+  /* default label is the OS and its version */
+  if (label[0] == NUL) {
+    strcpy(label, (os == OSHDOS) ? "HDOS" : ((os == OSMPM) ? "MPM" : "CPM"));
+    hexcat(label, osver);
+  }
+
+  if ((argc > 1) && (*argv[1] != '-')) {
+    printf("Usage: VBENCH <-c> <-fname> <-lname> <-knn> <-pxxx>\n");
+    printf("\t-c or -fname to append results to VBENCH.CSV or name\n");
+    printf("\tname (-l) labels this machine in the CSV file\n");
+    printf("\tnn is KB per throughput test (1 to %d, default 8)\n", MAXKB);
+    printf("\txxx is USB optional port in octal (default is %o)\n", VDATA);
+  }
+  else if ((buf = alloc(MAXBLK)) == 0)
+    printf("Not enough memory\n");
+  else if (vinit() == -1)
+    printf("Error initializing VDIP-1 device!\n");
+  else if (vfind_disk() == -1)
+    printf("No flash drive found!\n");
+  else {
+    if (bench() == -1)
+      printf("Error communicating with VDIP device - results incomplete\n");
+    showres();
+    if (f_csv && (nres > 0)) {
+      if (putcsv() == -1)
+        printf("Unable to write %s\n", csvname);
+      else
+        printf("\nResults added to %s\n", csvname);
+    }
+  }
+}
@@ -0,0 +1,356 @@
+/********************************************************
+** vbg - Version 4.3 for MP/M II
+**
+** This program is a background transfer process. Once
+** started it makes two MP/M queues, detaches from its
+** console and waits for copy jobs, so that files can be
+** moved to and from the USB drive while the console is
+** used for other work. Jobs are submitted with VQ, which
+** also shows the messages VBG posts as each job starts
+** and ends.
+**
+** Usage: vbg {-pxxx}
+**
+**    switches:
+**      -pxxx to specify octal port (default is 0261)
+**
+** Jobs (see vbg.h) copy one file each:
+**
+**    PUT d:file.ext {name.ext}      local file to USB
+**    GET file.ext {d:}{name.ext}    USB file to local disk
+**    QUIT                           stop VBG
+**
+** Jobs are run one at a time in the order they arrive.
+** Once detached VBG never writes to the console - under
+** MP/M that would wait for the console to be free - so
+** everything it has to say goes on the status queue. The
+** status queue keeps the last VQNMSG messages; older ones
+** are dropped if nobody reads them. QUIT deletes both
+** queues, and with them any messages still unread.
+**
+** The queue control blocks are in VBG's own memory. On a
+** banked system MP/M II can only pass messages through
+** them between processes in the same bank or in common
+** memory, which VBG, not being an RSP, can't be in; VQ
+** must then run in VBG's bank.
+**
+** Compiled with Software Toolworks C/80 V. 3.1 with support for
+** floats and longs.  Typical link statement:
+**
+** L80 vbg,vinc,vutil,pio,fprintf,seek,flibrary/s,stdlib/s,clibrary/s,vbg/n/e
+**
+** Our convention is to save all files with CP/M style
+** line endings (CR-LF).
+**
+** 18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+
+/* ensure globals live here */
+#define EXTERN
+#include "vutil.h"
+#include "vinc.h"
+#include "vbg.h"
+
+#define BUFFSIZE 256
+#define FSLEN   20
+
+/* MP/M II queue control block. The messages are kept in
+** the buffer at the end.
+*/
+struct qcb {
+  int qc_link;
+  char qc_name[8];
+  int qc_mlen;          /* bytes per message */
+  int qc_nmsg;          /* number of messages */
+  int qc_dqph;
+  int qc_nqph;
+  int qc_in;
+  int qc_out;
+  int qc_cnt;
+  char qc_buf[VQMSG*VQNMSG];
+};
+
+struct qcb jobq, statq;
+struct uqcb ujob, ustat;
+char jmsg[VQMSG];       /* job being run */
+char smsg[VQMSG];       /* status message */
+char jline[VQMSG];      /* copy of the job taken apart */
+
+char rwbuffer[BUFFSIZE];
+
+/* dosw - process any switches on the command line.
+** Switches are preceded by "-".  If a numeric value
+** is given there should be no space, for example:
+** -p261 specifies port 261.
+*/
+dosw(argc, argv)
+int argc;
+char *argv[];
+{
+  int i;
+  char *s;
+
+  for (i=argc-1; i>0; i--) {
+    s = argv[i];
+    if (*s++ == '-') {
+      switch (*s) {
+      case 'P':
+        ++s;
+        p_data = aotoi(s);
+        p_stat = p_data + 1;
+        break;
+      default:
+        printf("Invalid switch %c\n", *s);
+        break;
+      }
+    }
+  }
+}
+
+/* openq - open queue name for messages in buf
+**
+**  Returns:   -1 if there is no such queue
+*/
+int openq(uq, name, buf)
+struct uqcb *uq;
+char *name, *buf;
+{
+  strncpy(uq->uq_name, name, 8);
+  uq->uq_msg = buf;
+  return ((bdoshl(OPENQ, uq) & 0xFF) == 0) ? 0 : -1;
+}
+
+/* mkq - make queue name and open it
+**
+**  Returns:   -1 on error
+*/
+int mkq(q, uq, name, buf)
+struct qcb *q;
+struct uqcb *uq;
+char *name, *buf;
+{
+  strncpy(q->qc_name, name, 8);
+  q->qc_mlen = VQMSG;
+  q->qc_nmsg = VQNMSG;
+  if ((bdoshl(MAKEQ, q) & 0xFF) != 0)
+    return -1;
+  return openq(uq, name, buf);
+}
+
+/* post - put "what job: info" on the status queue. If it
+** is full the oldest message is dropped to make room.
+*/
+post(what, info)
+char *what, *info;
+{
+  static char line[VQMSG*2];
+
+  strcpy(line, what);
+  strcat(line, jmsg);
+  if (*info != NUL) {
+    strcat(line, ": ");
+    strcat(line, info);
+  }
+  strncpy(smsg, line, VQMSG-1);
+  smsg[VQMSG-1] = NUL;
+  if ((bdoshl(CWRITEQ, &ustat) & 0xFF) != 0) {
+    ustat.uq_msg = line;
+    bdoshl(CREADQ, &ustat);
+    ustat.uq_msg = smsg;
+    bdoshl(CWRITEQ, &ustat);
+  }
+}
+
+/* nextw - copy the next blank separated word of s (at
+** most n-1 characters) to w, returning what follows it.
+*/
+char *nextw(s, w, n)
+char *s, *w;
+int n;
+{
+  while (*s == ' ')
+    ++s;
+  while ((*s != NUL) && (*s != ' ')) {
+    if (--n > 0)
+      *w++ = *s;
+    ++s;
+  }
+  *w = NUL;
+  return s;
+}
+
+/* fpart - the file name part of d:file.ext */
+char *fpart(s)
+char *s;
+{
+  int i;
+
+  return ((i = index(s, ":")) == -1) ? s : s + i + 1;
+}
+
+/* bgput - copy local file src to USB file dst
+**
+**  Returns:   -1 on error
+*/
+int bgput(src, dst)
+char *src, *dst;
+{
+  int n, channel, rc;
+  long size;
+  static char info[FSLEN];
+
+  if ((channel = fopen(src, "rb")) == 0) {
+    post("FAILED ", "can't open local file");
+    return -1;
+  }
+  /* a fresh copy, not written over the old one */
+  vdlf(dst);
+  settd(FALSE);
+  if (vwopen(dst) == -1) {
+    post("FAILED ", "can't open USB file");
+    fclose(channel);
+    return -1;
+  }
+  rc = 0;
+  size = 0L;
+  while ((rc == 0) && ((n = read(channel, rwbuffer, BUFFSIZE)) > 0)) {
+    if ((rc = vwrite(rwbuffer, n)) == 0)
+      size += n;
+  }
+  fclose(channel);
+  vclose(dst);
+  commafmt(size, info, FSLEN);
+  strcat(info, " bytes");
+  post((rc == 0) ? "done " : "FAILED ", info);
+  return rc;
+}
+
+/* bgget - copy USB file src to local file dst. The last
+** block is NUL filled, as in vpip.
+**
+**  Returns:   -1 on error
+*/
+int bgget(src, dst)
+char *src, *dst;
+{
+  int i, n, channel, rc;
+  long size, left;
+  static char info[FSLEN];
+
+  if ((vdirf(src, &size) == -1) || (vropen(src) == -1)) {
+    post("FAILED ", "can't open USB file");
+    return -1;
+  }
+  if ((channel = fopen(dst, "wb")) == 0) {
+    vclose(src);
+    post("FAILED ", "can't open local file");
+    return -1;
+  }
+  rc = 0;
+  for (left=size; (rc == 0) && (left > 0L); left -= n) {
+    n = (left > BUFFSIZE) ? BUFFSIZE : (int) left;
+    if ((rc = vread(rwbuffer, n)) == 0) {
+      for (i=n; i<BUFFSIZE; i++)
+        rwbuffer[i] = 0;
+      if (write(channel, rwbuffer, BUFFSIZE) == -1)
+        rc = -1;
+    }
+  }
+  vclose(src);
+  fclose(channel);
+  commafmt(size, info, FSLEN);
+  strcat(info, " bytes");
+  post((rc == 0) ? "done " : "FAILED ", info);
+  return rc;
+}
+
+/* dojob - carry out the job in jmsg
+**
+**  Returns:   TRUE if VBG is to stop
+*/
+int dojob()
+{
+  char *s;
+  static char verb[8], src[FSLEN], dst[FSLEN*2];
+
+  strcpy(jline, jmsg);
+  s = nextw(jline, verb, 8);
+  s = nextw(s, src, FSLEN);
+  nextw(s, dst, FSLEN);
+
+  if (strcmp(verb, "QUIT") == 0)
+    return TRUE;
+  post("start ", "");
+  /* the USB drive may have been changed since the last job */
+  if (vfind_disk() == -1)
+    post("FAILED ", "no flash drive");
+  else if (strcmp(verb, "PUT") == 0) {
+    /* USB name defaults to the local one */
+    if (dst[0] == NUL)
+      strcpy(dst, fpart(src));
+    bgput(src, dst);
+  }
+  else if (strcmp(verb, "GET") == 0) {
+    /* a bare drive takes the USB name */
+    if ((dst[0] == NUL) || (*fpart(dst) == NUL))
+      strcat(dst, src);
+    bgget(src, dst);
+  }
+  else
+    post("FAILED ", "unknown job");
+  return FALSE;
+}
+
+/* serve - run jobs until told to quit */
+serve()
+{
+  /* wait for each job in turn */
+  do
+    bdoshl(READQ, &ujob);
+  while (!dojob());
+
+  bdoshl(DELQ, &jobq);
+  bdoshl(DELQ, &statq);
+}
+
+main(argc,argv)
+int argc;
+char *argv[];
+{
+  int userport;
+
+  /* Set default values */
+  p_data = VDATA;
+  p_stat = VSTAT;
+
+  /* set globals 'os' and 'osver' */
+  getosver();
+
+  /* check if user has a file specifying the port */
+  userport = chkport("A:");
+
+  /* process any switches */
+  dosw(argc, argv);
+
+  printf("VBG v%s, using %s port: [%o]\n", VERSION,
+    (userport ? "user-specified" : "default"), p_data);
+
+  if (os != OSMPM)
+    printf("VBG runs only under MP/M II\n");
+  else if (openq(&ujob, JOBQ, jmsg) == 0)
+    printf("VBG is already running\n");
+  else if (vinit() == -1)
+    printf("Error initializing VDIP-1 device!\n");
+  else if (vfind_disk() == -1)
+    printf("No flash drive found!\n");
+  else if ((mkq(&jobq, &ujob, JOBQ, jmsg) == -1) ||
+           (mkq(&statq, &ustat, STATQ, smsg) == -1))
+    printf("Unable to make queues\n");
+  else {
+    printf("Running in the background - submit jobs with VQ\n");
+    bdoshl(DETACH, 0);
+    serve();
+  }
+}
@@ -0,0 +1,40 @@
+/********************************************************
+** vbg.h
+**
+** definitions shared by VBG, the background transfer
+** process for MP/M II, and VQ, which submits jobs to it
+** and shows what it has done.
+**
+**      18 October 2026
+**
+********************************************************/
+
+/* MP/M II XDOS functions */
+#define MAKEQ   134     /* make queue */
+#define OPENQ   135     /* open queue */
+#define DELQ    136     /* delete queue */
+#define READQ   137     /* read queue, waiting for a message */
+#define CREADQ  138     /* conditional read queue */
+#define WRITEQ  139     /* write queue, waiting for room */
+#define CWRITEQ 140     /* conditional write queue */
+#define DETACH  147     /* detach console */
+
+/* queue names, 8 characters blank padded. Jobs are sent
+** to VBG on JOBQ; it posts what happened on STATQ.
+*/
+#define JOBQ    "VBGJOBS "
+#define STATQ   "VBGSTAT "
+
+/* every message is a NUL terminated line of text. A job
+** is "PUT d:file.ext {name.ext}", "GET file.ext {d:}{name.ext}"
+** or "QUIT".
+*/
+#define VQMSG   64      /* bytes per message */
+#define VQNMSG  8       /* messages each queue holds */
+
+/* user queue control block, for open, read and write */
+struct uqcb {
+  int uq_qcb;           /* queue, set by open queue */
+  char *uq_msg;         /* message buffer */
+  char uq_name[8];
+};
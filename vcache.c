@@ -0,0 +1,497 @@
+/********************************************************
+** vcache.c
+**
+** This library provides random access to a file on the
+** USB device through a small LRU cache of file blocks.
+** Without it, a program doing record lookups in a file on
+** the stick (an index, an ISAM-style data file) has to issue
+** a vseek() and vread() for every record and will fetch the
+** same blocks over and over. Here each block is fetched once
+** and kept until it is the least recently used; blocks that
+** are written to are kept dirty and written back, only the
+** changed bytes, when they are evicted, on vbflush() or on
+** vbclose().
+**
+** Usage Notes:
+**
+** Call vbinit(n) once to allocate n cache blocks of VBSIZE
+** bytes (if it is not called VBDEFN blocks are allocated on
+** the first vbopen()).  Open a file with vbopen(name, mode),
+** where mode is "r" for read only or "w" for read and write
+** (the file is created if it does not exist).  Position with
+** vbseek(), then vbread() and vbwrite() as needed, and finish
+** with vbclose().
+**
+** The VNC1L has only one file open at a time, so only one
+** file may be cached and no other file commands may be
+** issued while it is open.  The firmware will not read a
+** file opened for write, so in "w" mode the file is reopened
+** for read or write as the cache needs to fetch or write back
+** a block; access patterns that alternate fetching new blocks
+** and evicting dirty ones will cost an extra CLF/OPR/OPW.
+**
+** This code is designed for use with the Software Toolworks C/80
+** v. 3.1 compiler with the optional support for floats and longs.
+**
+**  18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+#include "vutil.h"
+#include "vinc.h"
+#include "vcache.h"
+
+/* device open state */
+#define VBNONE  0
+#define VBRD    1
+#define VBWR    2
+
+struct vblock *vbtab;   /* the cache blocks */
+int vbnblk;             /* number of cache blocks */
+unsigned vbclk;         /* LRU clock */
+char vbname[13];        /* name of the cached file */
+int vbwrok;             /* TRUE if opened for write */
+int vbdmode;            /* how the device has the file open */
+long vbpos;             /* current file position */
+long vblen;             /* logical file length */
+long vbdlen;            /* length of the file on the device */
+char vbzero[128];       /* zeros for padding holes */
+
+struct vblock *vbget();
+
+/********************************************************
+**
+** vbinit
+**
+** Allocate a cache of n blocks, releasing any previous
+** cache. Must not be called while a file is open.
+**
+** Returns:
+**    0 on Success
+**    -1 if not enough memory
+**
+********************************************************/
+int vbinit(n)
+int n;
+{
+  int i;
+  char *p;
+
+  if (vbnblk > 0) {
+    for (i = 0; i < vbnblk; i++)
+      free(vbtab[i].vbdata);
+    free(vbtab);
+    vbnblk = 0;
+  }
+  if ((vbtab = alloc(n * sizeof(struct vblock))) == 0)
+    return -1;
+  for (i = 0; i < n; i++) {
+    if ((p = alloc(VBSIZE)) == 0) {
+      /* settle for the blocks we could get */
+      if (i == 0) {
+        free(vbtab);
+        return -1;
+      }
+      break;
+    }
+    vbtab[i].vbdata = p;
+    vbtab[i].vbno = -1L;
+    vbtab[i].vbhi = 0;
+  }
+  vbnblk = i;
+  vbclk = 0;
+  return 0;
+}
+
+/********************************************************
+**
+** vbopen
+**
+** Open a USB file for cached access. Mode "r" is read
+** only; mode "w" allows reads and writes, creating the
+** file if needed. The position is set to 0.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error
+**
+********************************************************/
+int vbopen(name, mode)
+char *name, *mode;
+{
+  int i;
+
+  if (vbdmode != VBNONE)
+    return -1;
+  if ((vbnblk == 0) && (vbinit(VBDEFN) == -1))
+    return -1;
+
+  strncpy(vbname, name, 12);
+  vbname[12] = NUL;
+  vbwrok = (*mode == 'w');
+  for (i = 0; i < vbnblk; i++) {
+    vbtab[i].vbno = -1L;
+    vbtab[i].vbhi = 0;
+  }
+
+  if (vdirf(name, &vbdlen) == -1) {
+    if (!vbwrok)
+      return -1;
+    vbdlen = 0L;
+  }
+  vblen = vbdlen;
+  vbpos = 0L;
+
+  if (vbwrok) {
+    settd(FALSE);
+    if (vwopen(vbname) == -1)
+      return -1;
+    vbdmode = VBWR;
+  }
+  else {
+    if (vropen(vbname) == -1)
+      return -1;
+    vbdmode = VBRD;
+  }
+  return 0;
+}
+
+/********************************************************
+**
+** vbclose
+**
+** Write back any dirty blocks and close the file.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error
+**
+********************************************************/
+int vbclose()
+{
+  int rc;
+
+  if (vbdmode == VBNONE)
+    return -1;
+  rc = vbflush();
+  if (vclf() == -1)
+    rc = -1;
+  vbdmode = VBNONE;
+  return rc;
+}
+
+/********************************************************
+**
+** vbseek
+**
+** Set the position for the next vbread() or vbwrite().
+** No device I/O is done. In "w" mode the position may be
+** past the end of file; the gap is filled with zeros when
+** written.
+**
+** Returns:
+**    0 on Success
+**    -1 if position is beyond end of a read only file
+**
+********************************************************/
+int vbseek(p)
+long p;
+{
+  if ((p > vblen) && !vbwrok)
+    return -1;
+  vbpos = p;
+  return 0;
+}
+
+/********************************************************
+**
+** vbtell
+**
+** Returns the current position.
+**
+********************************************************/
+long vbtell()
+{
+  return vbpos;
+}
+
+/********************************************************
+**
+** vbread
+**
+** Read up to n bytes at the current position into buff,
+** fetching from the device only blocks not in the cache.
+**
+** Returns:
+**    number of bytes read (less than n at end of file)
+**    -1 on Error
+**
+********************************************************/
+int vbread(buff, n)
+char *buff;
+int n;
+{
+  struct vblock *b;
+  int off, cnt, nread;
+  char *p;
+
+  nread = 0;
+  while ((n > 0) && (vbpos < vblen)) {
+    if ((b = vbget(vbpos / VBSIZE)) == 0)
+      return -1;
+    off = (int) (vbpos % VBSIZE);
+    cnt = VBSIZE - off;
+    if (cnt > n)
+      cnt = n;
+    if ((long) cnt > vblen - vbpos)
+      cnt = (int) (vblen - vbpos);
+    p = b->vbdata + off;
+    n -= cnt;
+    nread += cnt;
+    vbpos += cnt;
+    while (cnt-- > 0)
+      *buff++ = *p++;
+  }
+  return nread;
+}
+
+/********************************************************
+**
+** vbwrite
+**
+** Write n bytes from buff at the current position. Data
+** goes into the cache and is written back later.
+**
+** Returns:
+**    n on Success
+**    -1 on Error
+**
+********************************************************/
+int vbwrite(buff, n)
+char *buff;
+int n;
+{
+  struct vblock *b;
+  int off, cnt, nwrit;
+  char *p;
+
+  if (!vbwrok)
+    return -1;
+  nwrit = 0;
+  while (n > 0) {
+    if ((b = vbget(vbpos / VBSIZE)) == 0)
+      return -1;
+    off = (int) (vbpos % VBSIZE);
+    cnt = VBSIZE - off;
+    if (cnt > n)
+      cnt = n;
+
+    /* widen the dirty range to take in this write */
+    if (b->vbhi == 0) {
+      b->vblo = off;
+      b->vbhi = off + cnt;
+    }
+    else {
+      if (off < b->vblo)
+        b->vblo = off;
+      if (off + cnt > b->vbhi)
+        b->vbhi = off + cnt;
+    }
+
+    p = b->vbdata + off;
+    n -= cnt;
+    nwrit += cnt;
+    vbpos += cnt;
+    while (cnt-- > 0)
+      *p++ = *buff++;
+    if (vbpos > vblen)
+      vblen = vbpos;
+  }
+  return nwrit;
+}
+
+/********************************************************
+**
+** vbflush
+**
+** Write back all dirty blocks, lowest block first so that
+** a file being extended grows without holes.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error
+**
+********************************************************/
+int vbflush()
+{
+  int i;
+  struct vblock *b;
+
+  for (;;) {
+    b = 0;
+    for (i = 0; i < vbnblk; i++)
+      if ((vbtab[i].vbhi != 0) &&
+          ((b == 0) || (vbtab[i].vbno < b->vbno)))
+        b = &vbtab[i];
+    if (b == 0)
+      return 0;
+    if (vbwback(b) == -1)
+      return -1;
+  }
+}
+
+/********************************************************
+**
+** vbget
+**
+** Return the cache block holding file block blk, loading
+** it into the least recently used slot if it is not
+** already cached.
+**
+** Returns:
+**    pointer to block on Success
+**    0 on Error
+**
+********************************************************/
+struct vblock *vbget(blk)
+long blk;
+{
+  int i;
+  struct vblock *b, *lru;
+
+  if (++vbclk == 0) {
+    /* clock wrapped, restart the ages */
+    for (i = 0; i < vbnblk; i++)
+      vbtab[i].vbage = 0;
+    vbclk = 1;
+  }
+
+  lru = vbtab;
+  for (i = 0; i < vbnblk; i++) {
+    b = &vbtab[i];
+    if (b->vbno == blk) {
+      b->vbage = vbclk;
+      return b;
+    }
+    if (b->vbno == -1L)
+      lru = b;
+    else if ((lru->vbno != -1L) && (b->vbage < lru->vbage))
+      lru = b;
+  }
+
+  /* a miss: evict the least recently used block */
+  b = lru;
+  if ((b->vbhi != 0) && (vbwback(b) == -1))
+    return 0;
+  b->vbno = -1L;
+  if (vbfill(b, blk) == -1)
+    return 0;
+  b->vbno = blk;
+  b->vbage = vbclk;
+  return b;
+}
+
+/********************************************************
+**
+** vbfill
+**
+** Load file block blk into cache block b.  Any part of
+** the block beyond the end of the file on the device is
+** zero filled.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error
+**
+********************************************************/
+int vbfill(b, blk)
+struct vblock *b;
+long blk;
+{
+  long start;
+  int i, n;
+
+  n = 0;
+  start = blk * VBSIZE;
+  if (start < vbdlen) {
+    n = (vbdlen - start > VBSIZE) ? VBSIZE : (int) (vbdlen - start);
+    if (vbmode(VBRD) == -1)
+      return -1;
+    if ((vseek(start) == -1) || (vread(b->vbdata, n) == -1))
+      return -1;
+  }
+  for (i = n; i < VBSIZE; i++)
+    b->vbdata[i] = 0;
+  return 0;
+}
+
+/********************************************************
+**
+** vbwback
+**
+** Write the dirty range of block b back to the device,
+** first padding with zeros if it starts past the current
+** end of the file on the device.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error
+**
+********************************************************/
+int vbwback(b)
+struct vblock *b;
+{
+  long start, end;
+  int n;
+
+  if (vbmode(VBWR) == -1)
+    return -1;
+  start = b->vbno * VBSIZE + b->vblo;
+  end = start + (b->vbhi - b->vblo);
+
+  if (start > vbdlen) {
+    if (vseek(vbdlen) == -1)
+      return -1;
+    while (vbdlen < start) {
+      n = (start - vbdlen > 128L) ? 128 : (int) (start - vbdlen);
+      if (vwrite(vbzero, n) == -1)
+        return -1;
+      vbdlen += n;
+    }
+  }
+  if ((vseek(start) == -1) ||
+      (vwrite(b->vbdata + b->vblo, b->vbhi - b->vblo) == -1))
+    return -1;
+  if (end > vbdlen)
+    vbdlen = end;
+  b->vbhi = 0;
+  return 0;
+}
+
+/********************************************************
+**
+** vbmode
+**
+** Make sure the device has the cached file open for read
+** (VBRD) or write (VBWR), reopening it if necessary.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error
+**
+********************************************************/
+int vbmode(m)
+int m;
+{
+  int rc;
+
+  if (vbdmode == m)
+    return 0;
+  vclf();
+  if (m == VBWR)
+    rc = vwopen(vbname);
+  else
+    rc = vropen(vbname);
+  vbdmode = (rc == -1) ? VBNONE : m;
+  return rc;
+}
@@ -0,0 +1,37 @@
+/********************************************************
+** vcache.h
+**
+** template definitions for the vcache random-access
+** block cache library, which sits on top of the vinc
+** library.
+**
+**      18 October 2026
+**
+********************************************************/
+
+/* cache block size. Files are cached in VBSIZE pieces
+** keyed by block number (offset / VBSIZE).
+*/
+#define VBSIZE  512
+
+/* default number of blocks if vbinit() is not called */
+#define VBDEFN  8
+
+/* one cache block */
+struct vblock {
+  long vbno;              /* file block number, -1 if empty */
+  unsigned vbage;         /* LRU stamp of last use */
+  int vblo;               /* dirty byte range [vblo, vbhi) */
+  int vbhi;               /* vbhi == 0 means clean */
+  char *vbdata;           /* VBSIZE bytes of file data */
+};
+
+/* block cache routines */
+int vbinit();
+int vbopen();
+int vbclose();
+int vbseek();
+long vbtell();
+int vbread();
+int vbwrite();
+int vbflush();
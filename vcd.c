@@ -4,7 +4,7 @@
 ** This program implements a simple Change Directory app to change
 ** the current directory on the attached USB flash drive.
 **
-** Usage:  vcd path
+** Usage:  vcd path {-s} {-pxxx}
 **
 ** It changes the directory to the value specified on
 ** the command line.  Unix-style forward slash characters ("/")
@@ -19,7 +19,7 @@
 ** Compiled with Software Toolworks C/80 V. 3.1 with support for
 ** floats and longs.  Typical link statement:
 **
-** L80 vcd,vinc,vutil,pio,fprintf,scanf,flibrary/s,stdlib/s,clibrary/s,vcd/n/e
+** L80 vcd,vinc,vutil,pio,fprintf,seek,scanf,flibrary/s,stdlib/s,clibrary/s,vcd/n/e
 **
 ** Our convention is to save all files with CP/M style
 ** line endings (CR-LF). The HDOS version of C/80 is picky
@@ -48,6 +48,9 @@
 /* array used to track successful vcd commands */
 char dtrack[80];
 
+/* show USB statistics at exit (-s) */
+int f_stats;
+
 /* dosw - process any switches on the command line.
 ** Switches are preceded by "-".  If a numeric value
 ** is given there should be no space, for example:
@@ -71,6 +74,9 @@ char *argv[];
     if (*s++ == '-') {
       /* have a switch! */
       switch (*s) {
+      case 'S':
+        f_stats = TRUE;
+        break;
       case 'P':
         ++s;
         p_data = aotoi(s);
@@ -124,6 +130,7 @@ char *argv[];
   else if ((argc < 2) || (index(argv[1], "\\") != -1)) {
     printf("Usage: vcd <directory> <-pxxx>\n");
     printf("Use forward slash (/) for directory specification\n");
+    printf("\t-s to show USB statistics at exit\n");
     printf("\txxx is USB optional port in octal (default is %o)\n", VDATA);
   }
   else {
@@ -176,4 +183,6 @@ char *argv[];
     else
 	  printf("No changes made\n");
   }
+  if (f_stats)
+    vstats();
 }
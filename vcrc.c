@@ -0,0 +1,282 @@
+/********************************************************
+** vcrc.c
+**
+** This library computes CRC-32 and CRC-16 checksums of
+** files on the USB device, read through the vinc library,
+** and of local files. Both are computed in the same pass;
+** the per-byte work is done by the table-driven assembly
+** routine crcupd() in crc.dri.
+**
+** CRC-32 is the common reflected form (as used by PKZIP),
+** so results can be checked against tools on other
+** systems. CRC-16 is the CCITT (XMODEM) form.
+**
+** Usage Notes:
+**
+** Call crcini() once to build the tables. To checksum data
+** of your own call crcbeg(), then crcupd(buf, n) for each
+** piece, then crcend(s32, s16) to get the results as hex
+** strings. vcrcf() and lcrcf() do all of this for a whole
+** USB or local file. crcver() checks a copy against the
+** checksums kept while making it; crcpver() does the same
+** for a copy on a second VDIP1.
+**
+** This code is designed for use with the Software Toolworks C/80
+** v. 3.1 compiler with the optional support for floats and longs.
+**
+**  18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+#include "vutil.h"
+#include "vinc.h"
+#include "vcrc.h"
+
+int crcok;              /* TRUE once tables are built */
+char crcbuff[VCBSIZE];  /* file read buffer */
+
+char *crchex();
+
+/********************************************************
+**
+** crcini
+**
+** Fill in the CRC tables used by crcupd(). Only the first
+** call does any work.
+**
+********************************************************/
+int crcini()
+{
+  char *t;
+  int i, j;
+  long c;
+  unsigned h;
+
+  if (crcok)
+    return;
+  t = crctab();
+  for (i=0; i<256; i++) {
+    /* CRC-32 is reflected: shift right, poly EDB88320 */
+    c = i;
+    for (j=0; j<8; j++)
+      if (c & 1L)
+        c = ((c >> 1) & 0x7FFFFFFFL) ^ 0xEDB88320L;
+      else
+        c = (c >> 1) & 0x7FFFFFFFL;
+    t[i] = c & 0xFFL;
+    t[i+256] = (c >> 8) & 0xFFL;
+    t[i+512] = (c >> 16) & 0xFFL;
+    t[i+768] = (c >> 24) & 0xFFL;
+
+    /* CRC-16 shifts left, poly 1021 */
+    h = i << 8;
+    for (j=0; j<8; j++)
+      if (h & 0x8000)
+        h = (h << 1) ^ 0x1021;
+      else
+        h = h << 1;
+    t[i+1024] = (h >> 8) & 0xFF;
+    t[i+1280] = h & 0xFF;
+  }
+  crcok = TRUE;
+}
+
+/********************************************************
+**
+** crcbeg
+**
+** Start a new pair of checksums.
+**
+********************************************************/
+int crcbeg()
+{
+  char *st;
+  int i;
+
+  st = crcst();
+  for (i=0; i<4; i++)
+    st[i] = 0xFF;
+  st[4] = st[5] = 0;
+}
+
+/********************************************************
+**
+** crcend
+**
+** Return the checksums of the data given to crcupd() since
+** crcbeg(), as upper case hex strings: 8 digits of CRC-32
+** in s32 (C32LEN bytes) and 4 of CRC-16 in s16 (C16LEN
+** bytes).
+**
+********************************************************/
+int crcend(s32, s16)
+char *s32, *s16;
+{
+  char *st;
+  int i;
+
+  st = crcst();
+  for (i=3; i>=0; i--)
+    s32 = crchex(~st[i], s32);
+  s16 = crchex(st[5], s16);
+  crchex(st[4], s16);
+}
+
+/* crchex - put byte b in s as two hex digits, return
+** pointer past them (which is left NUL terminated).
+*/
+char *crchex(b, s)
+int b;
+char *s;
+{
+  static char hex[] = "0123456789ABCDEF";
+
+  *s++ = hex[(b >> 4) & 0x0F];
+  *s++ = hex[b & 0x0F];
+  *s = NUL;
+  return s;
+}
+
+/********************************************************
+**
+** vcrcf
+**
+** Compute the checksums of a file on the USB device. The
+** file length is returned in len.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error (file not found or read error)
+**
+********************************************************/
+int vcrcf(name, len, s32, s16)
+char *name;
+long *len;
+char *s32, *s16;
+{
+  long left;
+  int n;
+
+  if ((vdirf(name, len) == -1) || (vropen(name) == -1))
+    return -1;
+  crcbeg();
+  for (left = *len; left > 0L; left -= n) {
+#ifndef HDOS
+    /* check for ^C */
+    CtlCk();
+#endif
+    n = (left > VCBSIZE) ? VCBSIZE : (int) left;
+    if (vread(crcbuff, n) == -1) {
+      vclf();
+      return -1;
+    }
+    crcupd(crcbuff, n);
+  }
+  crcend(s32, s16);
+  return vclf();
+}
+
+/********************************************************
+**
+** lcrcf
+**
+** Compute the checksums of a local file. Local files are
+** a whole number of records long, so if max is not -1 no
+** more than max bytes are checksummed; this lets a local
+** copy be checked against the exact length of the USB
+** original. The number of bytes checksummed is returned
+** in len.
+**
+** Returns:
+**    0 on Success
+**    -1 if the file can't be opened
+**
+********************************************************/
+int lcrcf(name, max, len, s32, s16)
+char *name;
+long max, *len;
+char *s32, *s16;
+{
+  int chan, n;
+
+  if ((chan = fopen(name, "rb")) == 0)
+    return -1;
+  crcbeg();
+  *len = 0L;
+  while ((n = read(chan, crcbuff, VCBSIZE)) > 0) {
+#ifndef HDOS
+    /* check for ^C */
+    CtlCk();
+#endif
+    if ((max != -1L) && (*len + n > max))
+      n = (int) (max - *len);
+    crcupd(crcbuff, n);
+    *len += n;
+    if (n < VCBSIZE)
+      break;
+  }
+  fclose(chan);
+  crcend(s32, s16);
+  return 0;
+}
+
+/********************************************************
+**
+** crcver
+**
+** Verify a copy against the checksums of the data sent or
+** received while making it. The caller does crcbeg() and
+** crcupd() on each block as it is copied; this finishes
+** those checksums and compares them with a single read of
+** the copy - the USB file 'name' if usb is TRUE, otherwise
+** the first len bytes of local file 'name'.
+**
+** Returns:
+**    0 if the copy matches
+**    -1 if it does not, or it can't be read
+**
+********************************************************/
+int crcver(usb, name, len)
+int usb;
+char *name;
+long len;
+{
+  char a32[C32LEN], a16[C16LEN], b32[C32LEN], b16[C16LEN];
+  long blen;
+  int rc;
+
+  crcend(a32, a16);
+  if (usb)
+    rc = vcrcf(name, &blen, b32, b16);
+  else
+    rc = lcrcf(name, len, &blen, b32, b16);
+  if ((rc == -1) || (blen != len) || (strcmp(a32, b32) != 0) ||
+      (strcmp(a16, b16) != 0))
+    return -1;
+  return 0;
+}
+
+/********************************************************
+**
+** crcpver
+**
+** crcver() of USB file 'name' on the VDIP1 at port, which
+** need not be the default device.
+**
+** Returns:
+**    0 if the copy matches
+**    -1 if it does not, or it can't be read
+**
+********************************************************/
+int crcpver(port, name, len)
+int port;
+char *name;
+long len;
+{
+  int rc;
+
+  port = vport(port);
+  rc = crcver(TRUE, name, len);
+  vport(port);
+  return rc;
+}
@@ -0,0 +1,30 @@
+/********************************************************
+** vcrc.h
+**
+** template definitions for the vcrc checksum library
+** and its assembly kernel (crc.dri).
+**
+**      18 October 2026
+**
+********************************************************/
+
+/* size of the buffer used to read files */
+#define VCBSIZE 1024
+
+/* lengths of the hex strings returned by crcend() */
+#define C32LEN  9
+#define C16LEN  5
+
+/* checksum routines */
+int crcini();
+int crcbeg();
+int crcend();
+int vcrcf();
+int lcrcf();
+int crcver();
+int crcpver();
+
+/* assembly kernel */
+char *crctab();
+char *crcst();
+int crcupd();
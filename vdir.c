@@ -12,12 +12,14 @@
 ** the user may specify the '-b' ("brief") switch, which requires
 ** only a single pass and is much faster.
 **
-** Usage:  vdir {-pxxx} {-b}
+** Usage:  vdir {-pxxx} {-b} {-s}
+**
+** The -s switch shows USB transfer statistics at exit.
 **
 ** Compiled with Software Toolworks C/80 V. 3.1 with support for
 ** floats and longs.  Typical link statement:
 **
-** L80 vdir,vinc,vutil,pio,fprintf,scanf,flibrary/s,stdlib/s,clibrary/s,vdir/n/e
+** L80 vdir,vinc,vutil,pio,fprintf,seek,scanf,flibrary/s,stdlib/s,clibrary/s,vdir/n/e
 **
 ** This code uses ifndef to insert a call to CtlCk(), which 
 ** is necessary in CP/M to check for CTRL-C interrupts. This
@@ -205,6 +207,9 @@ char *s;
   }
 }
 
+/* show USB statistics at exit (-s) */
+int f_stats;
+
 /* process switches */
 dosw(argc, argv)
 int argc;
@@ -221,6 +226,9 @@ char *argv[];
     if (*s++ == '-') {
       /* have a switch! */
       switch (*s) {
+      case 'S':
+        f_stats = TRUE;
+        break;
       case 'P':
         ++s;
         p_data = aotoi(s);
@@ -341,4 +349,6 @@ char *argv[];
     /* sign off with total file count */
     printf("\n%d Files\n", nfiles);   
   }
+  if (f_stats)
+    vstats();
 }
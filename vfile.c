@@ -0,0 +1,249 @@
+/********************************************************
+** vfile.c
+**
+** This library provides a small stdio-like buffered
+** stream interface to files on the USB device, built on
+** the vinc library. Each vread() or vwrite() is a complete
+** RDF or WRF command followed by a prompt, so programs that
+** read a text file a line at a time, or write small records,
+** would otherwise pay a round trip per call. Here reads are
+** done ahead and writes held back in VFBSIZE chunks, so that
+** small I/O runs at bulk transfer speed.
+**
+** Usage Notes:
+**
+** After vinit() and vfind_disk(), open a file with
+** vfopen(name, mode), where mode is "r" (read), "w" (write,
+** replacing any existing file) or "a" (append).  Read with
+** vgetc() and vfgets(), write with vputc() and vfputs(), and
+** finish with vfclose(), which flushes any buffered output.
+** The VNC1L has only one file open at a time, so only one
+** stream may be open and no other file commands may be
+** issued while it is.
+**
+** This code is designed for use with the Software Toolworks C/80
+** v. 3.1 compiler with the optional support for floats and longs.
+**
+**  18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+#include "vutil.h"
+#include "vinc.h"
+#include "vfile.h"
+
+/********************************************************
+**
+** vfopen
+**
+** Open a USB file as a buffered stream.  Mode "r" opens
+** for reading, "w" for writing (any existing file is
+** deleted first) and "a" for writing at the end of the
+** file. The time/date stamp for written files is taken
+** from the system clock.
+**
+** Returns:
+**    pointer to the stream if successful
+**    0 on error
+**
+********************************************************/
+struct vfile *vfopen(name, mode)
+char *name, *mode;
+{
+  struct vfile *f;
+  long len;
+
+  if ((f = alloc(sizeof(struct vfile))) == 0)
+    return 0;
+
+  strncpy(f->vfname, name, 12);
+  f->vfname[12] = NUL;
+  f->vfcnt = 0;
+  f->vfptr = f->vfbuf;
+  f->vfleft = 0L;
+
+  if (*mode == 'r') {
+    /* the firmware does not report end of file, so
+    ** find out up front how much there is to read
+    */
+    f->vfmode = VFREAD;
+    if ((vdirf(name, &len) == -1) || (vropen(name) == -1)) {
+      free(f);
+      return 0;
+    }
+    f->vfleft = len;
+  }
+  else {
+    f->vfmode = VFWRITE;
+    if (*mode == 'w')
+      vdlf(name);
+    settd(FALSE);
+    if (vwopen(name) == -1) {
+      free(f);
+      return 0;
+    }
+  }
+  return f;
+}
+
+/********************************************************
+**
+** vfclose
+**
+** Close a stream, first writing out any buffered data.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error
+**
+********************************************************/
+int vfclose(f)
+struct vfile *f;
+{
+  int rc;
+
+  rc = 0;
+  if (f->vfmode == VFWRITE)
+    rc = vfflush(f);
+  if (vclose(f->vfname) == -1)
+    rc = -1;
+  free(f);
+  return rc;
+}
+
+/********************************************************
+**
+** vgetc
+**
+** Return the next byte from a stream opened for reading,
+** refilling the buffer with a single RDF when it is empty.
+**
+** Returns:
+**    the byte (0..255)
+**    VFEOF at end of file or on error
+**
+********************************************************/
+int vgetc(f)
+struct vfile *f;
+{
+  int n;
+
+  if (f->vfcnt == 0) {
+    if (f->vfleft <= 0L)
+      return VFEOF;
+    n = (f->vfleft > VFBSIZE) ? VFBSIZE : (int) f->vfleft;
+    if (vread(f->vfbuf, n) == -1) {
+      f->vfleft = 0L;
+      return VFEOF;
+    }
+    f->vfleft -= n;
+    f->vfcnt = n;
+    f->vfptr = f->vfbuf;
+  }
+  --f->vfcnt;
+  return *f->vfptr++ & 0xFF;
+}
+
+/********************************************************
+**
+** vfgets
+**
+** Read a line of at most n-1 bytes into s.  Reading stops
+** after a newline, which is kept, as in fgets(). Line
+** endings are otherwise passed through untouched.
+**
+** Returns:
+**    s on Success
+**    0 if at end of file
+**
+********************************************************/
+char *vfgets(s, n, f)
+char *s;
+int n;
+struct vfile *f;
+{
+  int c;
+  char *p;
+
+  p = s;
+  while (--n > 0) {
+    if ((c = vgetc(f)) == VFEOF)
+      break;
+    *p++ = c;
+    if (c == '\n')
+      break;
+  }
+  *p = NUL;
+  return (p == s) ? 0 : s;
+}
+
+/********************************************************
+**
+** vputc
+**
+** Add a byte to a stream opened for writing. A full
+** buffer is written out with a single WRF.
+**
+** Returns:
+**    the byte on Success
+**    VFEOF on Error
+**
+********************************************************/
+int vputc(c, f)
+char c;
+struct vfile *f;
+{
+  if (f->vfcnt == VFBSIZE)
+    if (vfflush(f) == -1)
+      return VFEOF;
+  *f->vfptr++ = c;
+  ++f->vfcnt;
+  return c & 0xFF;
+}
+
+/********************************************************
+**
+** vfputs
+**
+** Write a NUL-terminated string to a stream. No newline
+** is added.
+**
+** Returns:
+**    0 on Success
+**    VFEOF on Error
+**
+********************************************************/
+int vfputs(s, f)
+char *s;
+struct vfile *f;
+{
+  while (*s != NUL)
+    if (vputc(*s++, f) == VFEOF)
+      return VFEOF;
+  return 0;
+}
+
+/********************************************************
+**
+** vfflush
+**
+** Write out any data held in the buffer of a stream
+** opened for writing.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error
+**
+********************************************************/
+int vfflush(f)
+struct vfile *f;
+{
+  int rc;
+
+  rc = 0;
+  if ((f->vfmode == VFWRITE) && (f->vfcnt > 0))
+    rc = vwrite(f->vfbuf, f->vfcnt);
+  f->vfcnt = 0;
+  f->vfptr = f->vfbuf;
+  return rc;
+}
@@ -0,0 +1,41 @@
+/********************************************************
+** vfile.h
+**
+** template definitions for the vfile buffered stream
+** library, which sits on top of the vinc library.
+**
+**      18 October 2026
+**
+********************************************************/
+
+/* size of the read-ahead / write-behind buffer. every
+** refill or flush is a single RDF or WRF command.
+*/
+#define VFBSIZE 1024
+
+/* stream modes */
+#define VFREAD  1
+#define VFWRITE 2
+
+#define VFEOF   -1
+
+/* a buffered USB file stream. The VNC1L has only one
+** file open at a time, so only one stream may be open.
+*/
+struct vfile {
+  int vfmode;             /* VFREAD or VFWRITE */
+  long vfleft;            /* (read) bytes still on the device */
+  int vfcnt;              /* bytes left in (read) or added to (write) buffer */
+  char *vfptr;            /* next byte in the buffer */
+  char vfname[13];        /* USB file name */
+  char vfbuf[VFBSIZE];
+};
+
+/* buffered stream routines */
+struct vfile *vfopen();
+int vfclose();
+int vgetc();
+char *vfgets();
+int vputc();
+int vfputs();
+int vfflush();
@@ -1,35 +1,49 @@
 /********************************************************
 ** vget - Version 4.1 for CP/M and HDOS
 **
-** This program copies a single file from a USB flash device
-** to the local CP/M or HDOS file system. For multiple-file
-** copies use VPIP. VGET may be preferred over VPIP for 
-** copying only a few files because it is fast.
+** This program copies files from a USB flash device to the
+** local CP/M or HDOS file system. VGET may be preferred over
+** VPIP for copying only a few files because it is fast. All
+** files are copied in a single session with the device.
 **
-** Usage: vget file {dest} {-pxxx}
+** Usage: vget file {file} ... {dest} {-pxxx}
 **
-**    'file' is the name of the source file on the USB drive.
-**    Only "8.3" file names are supported (no long file names).
+**    'file' is the name of a source file on the USB drive,
+**    or a pattern using the "*" and "?" wild cards, which is
+**    matched against the USB directory. Only "8.3" file names
+**    are supported (no long file names).
 **
 **    {dest} is an optional drive ID, e.g. D: (CP/M) or
 **    SY1: (HDOS), or a complete file specification (e.g.
-**    D:NEWFILE.DAT or DK0:ANYNAME.TXT). If {dest} is not
-**    specified the destination file takes the same name as
-**    the source file and is created on the current or default
-**    drive.  If only a device name is specified for {dest}
-**    then the source file name is used but the file is saved
-**    on the specified device. Existing files are overwritten
+**    D:NEWFILE.DAT or DK0:ANYNAME.TXT) - it is recognized by
+**    the ':'. As in the single file VGET a plain name that
+**    is the second of exactly two names is also taken as
+**    {dest}: "vget FOO.TXT NEW.TXT" copies FOO.TXT to
+**    NEW.TXT. If {dest} is not specified the destination file
+**    takes the same name as the source file and is created on
+**    the current or default drive.  If only a device name is
+**    specified for {dest} then the source file name is used
+**    but the file is saved on the specified device. A complete
+**    file specification is only allowed when a single file is
+**    copied. Existing files are overwritten
 **    without warning. For operating systems that support time
 **    and date stamping the current time/date are used when
 **    creating the file.
 **
 **    switches:
+**      -k to verify each copy (see below)
+**      -s to show USB transfer statistics at exit
 **      -pxxx to specify octal port (default is 0331)
 **
+**    With -k a checksum is kept of the bytes received while
+**    copying, and the local file is then read back once and
+**    checked against it. This costs a local read rather
+**    than a second transfer over the USB interface.
+**
 ** Compiled with Software Toolworks C/80 V. 3.1 with support for
 ** floats and longs.  Typical link statement:
 **
-** L80 vget,vinc,vutil,pio,fprintf,scanf,flibrary/s,stdlib/s,clibrary/s,vget/n/e
+** L80 vget,vcrc,crc,vinc,vutil,pio,fprintf,seek,scanf,flibrary/s,stdlib/s,clibrary/s,vget/n/e
 **
 ** Our convention is to save all files with CP/M style
 ** line endings (CR-LF). The HDOS version of C/80 is picky
@@ -45,6 +59,11 @@
 **
 ** 12 April 2025 - simplified version and port reporting to single line.
 **
+** 18 October 2026 - multiple files and wild cards, matched
+** against a single streamed directory listing.
+**
+** 18 October 2026 - "-k" verifies each copy as it is made.
+**
 ********************************************************/
 #include "fprintf.h"
 
@@ -52,9 +71,11 @@
 #define EXTERN
 #include "vutil.h"
 #include "vinc.h"
+#include "vcrc.h"
 
 #define BUFFSIZE  256
 #define FSLEN   20
+#define NAMBUF  2048    /* space for names of files to copy */
 
 /* buffer used for read/write */
 char rwbuffer[BUFFSIZE];
@@ -62,6 +83,17 @@ char rwbuffer[BUFFSIZE];
 /* source and destination filespecs */
 char srcfile[FSLEN], destfile[FSLEN];
 
+/* destination device (or full filespec) from the command
+** line and the names of the files to copy, stored one
+** after the other as NUL-terminated strings.
+*/
+char destspec[FSLEN];
+char names[NAMBUF];
+struct vnlist nlist;
+
+/* verify copies (-k) */
+int f_verify;
+
 /* vcget - get file from USB source to local destination
 **  (derived from code in VGET)
 **
@@ -73,9 +105,10 @@ char srcfile[FSLEN], destfile[FSLEN];
 vcget(source, dest)
 char *source, *dest;
 {
-  int nblocks, nbytes, i, channel, rc, done;
-  long filesize;
+  int nbytes, j, channel, rc, done;
+  long filesize, nblocks, i;
   char fsize[15];
+  static char blk[12];
   
   rc = 0;
   
@@ -87,9 +120,11 @@ char *source, *dest;
     commafmt(filesize, fsize, 15);
     printf("USB:%-12s  %s bytes --> ", source, fsize);
   
-    /* NOTE: assumes file size < 8 meg */
-    nblocks = filesize/BUFFSIZE;
-    nbytes = filesize % BUFFSIZE;
+    /* block count and remainder, taking the size as
+    ** unsigned so files up to 4 GB stream through
+    */
+    nblocks = ((filesize >> 1) & 0x7FFFFFFFL) / (BUFFSIZE / 2);
+    nbytes = (int) (filesize & (BUFFSIZE - 1));
     
     /* open source file on flash device for read */
     if (vropen(source) == -1) {
@@ -101,11 +136,13 @@ char *source, *dest;
       rc = -1;
     }
     else {
+      if (f_verify)
+        crcbeg();
       /* source and destination files open - begin copying */
-      for (done=FALSE, i=1; ((i<=nblocks) && (!done)); i++) {
+      for (done=FALSE, i=1L; ((i<=nblocks) && (!done)); i++) {
         /* read a block from input file */
         if (vread(rwbuffer, BUFFSIZE) == -1) {
-          printf("\nError reading block %d\n", i);
+          printf("\nError reading block %s\n", ltodec(i, blk));
           done = TRUE;
           rc = -1;
         }
@@ -114,10 +151,12 @@ char *source, *dest;
           rc = -1;
           done = TRUE;
         }
+        else if (f_verify)
+          crcupd(rwbuffer, BUFFSIZE);
       }
       /* NUL fill the buffer before last write */
-      for (i=0; i<BUFFSIZE; i++)
-        rwbuffer[i]=0;
+      for (j=0; j<BUFFSIZE; j++)
+        rwbuffer[j]=0;
   
       /* if any extra bytes process them ... */
       if ((nbytes > 0) && !done) {
@@ -130,16 +169,29 @@ char *source, *dest;
           printf("\nError writing to %s\n", dest);
           rc = -1;
         }
+        else if (f_verify)
+          crcupd(rwbuffer, nbytes);
       }
       
       /* report results */
-      printf("%-12s\n", dest);
+      printf("%-12s", dest);
 
       /* close file on VDIP */
       vclose(source);
   
       /* close output file */
       fclose(channel);
+
+      /* check the copy against what was received */
+      if (f_verify && (rc == 0)) {
+        if (crcver(FALSE, dest, filesize) == -1) {
+          printf("  ** VERIFY FAILED **");
+          rc = -1;
+        }
+        else
+          printf("  verified");
+      }
+      printf("\n");
     }
   }
   
@@ -147,60 +199,82 @@ char *source, *dest;
 }
 
 
-/* dofiles - parse out the source and destination
-** file specifications.  source file *must* be in
-** argv[1].  If destination filespec is just a drive
-** identifier then pre-pend that to the source name.
-** Bug: if srcfile length > FSLEN this code may overwrite
-** data.
+/* dofiles - build the list of files to copy.  Arguments
+** containing ':' give the destination; the others are
+** source file names or wild card patterns.  Plain names
+** are taken as given, while patterns are all matched
+** against one streamed "DIR" listing of the USB drive
+** by vlswild().  The second of exactly two names is the destination if
+** it is a plain name, as in the single file VGET.
+**
+** Returns the number of files found, -1 on error.
 */
-dofiles(argc, argv)
+int dofiles(argc, argv)
 int argc;
 char *argv[];
 {
-  int i, havedest, cindex;
+  int i, nargs, ldest;
   char *s;
-  
-  havedest = FALSE;
-  /* source file must be argv[1] */
-  strcpy(srcfile, argv[1]);
-    
-  /* destination file may not be designated, in which
-  ** case it defaults to same as source file, or it
-  ** may simply be a drive specification, in which case
-  ** the destination file name is the same as the
-  ** source, or it may be a full filespec.
-  */
-  for (i=2; (i<argc) && (!havedest); i++) {
-    s = argv[i];
-    /* ignore switches */
-    if (*s != '-') {
-      /* first non-switch taken as dest filespec */
-      havedest = TRUE;
-      if ((cindex = index(s, ":")) == -1)
-        /* no device spec found - just copy */
-        strncpy(destfile, s, FSLEN-1);
-      else if (s[cindex+1] == '\0') {
-        /* device only - bug here if srcfile
-        ** is too long!
-        */
-        strcpy(destfile, s);
-        strcat(destfile, srcfile);
-      }
-      else
-        /* full filespec given, just copy */
-        strncpy(destfile, s, FSLEN-1);
+
+  destspec[0] = NUL;
+  vnlinit(&nlist, names, NAMBUF);
+
+  /* "vget FOO.TXT NEW.TXT" */
+  for (i=1, nargs=0, ldest=0; i<argc; i++)
+    if (*argv[i] != '-') {
+      ++nargs;
+      ldest = i;
     }
+  s = argv[ldest];
+  if ((nargs == 2) && (index(s, ":") == -1) && !iswild(s))
+    strncpy(destspec, s, FSLEN-1);
+  else
+    ldest = 0;
+
+  for (i=1; i<argc; i++) {
+    s = argv[i];
+    /* ignore switches, a plain destination and patterns */
+    if ((*s == '-') || (i == ldest))
+      ;
+    else if (index(s, ":") != -1)
+      strncpy(destspec, s, FSLEN-1);
+    else if (iswild(s))
+      ;
+    else if (vnladd(&nlist, s) == -1)
+      return -1;
   }
-  
-  /* if no destination filespec was found after
-  ** scanning all of the arguments then just copy
-  ** source filespec to destination one.
-  */
-  if (!havedest)
-    strcpy(destfile, srcfile);
+
+  if (vlswild(&nlist, argc, argv, 1) == -1)
+    printf("Too many files - only %d copied\n", nlist.nl_n);
+  return nlist.nl_n;
 }
 
+/* dstname - form the destination file name for a source
+** file.  If the destination is just a drive identifier
+** then pre-pend that to the source name.
+*/
+int dstname(src)
+char *src;
+{
+  int cindex;
+
+  if (destspec[0] == NUL)
+    /* no destination - same name on default drive */
+    strcpy(destfile, src);
+  else if (destspec[(cindex = index(destspec, ":"))+1] == NUL) {
+    /* device only */
+    strcpy(destfile, destspec);
+    strncpy(destfile+cindex+1, src, FSLEN-cindex-2);
+    destfile[FSLEN-1] = NUL;
+  }
+  else
+    /* full filespec given, just copy */
+    strcpy(destfile, destspec);
+}
+
+/* show USB statistics at exit (-s) */
+int f_stats;
+
 /* dosw - process any switches on the command line.
 ** Switches are preceded by "-".  If a numeric value
 ** is given there should be no space, for example:
@@ -224,6 +298,12 @@ char *argv[];
     if (*s++ == '-') {
       /* have a switch! */
       switch (*s) {
+      case 'K':
+        f_verify = TRUE;
+        break;
+      case 'S':
+        f_stats = TRUE;
+        break;
       case 'P':
         ++s;
         p_data = aotoi(s);
@@ -242,7 +322,8 @@ main(argc,argv)
 int argc;
 char *argv[];
 {
-  int userport;
+  int i, userport;
+  char *s;
   
   printf("VGET v%s, ", VERSION);
 
@@ -270,13 +351,12 @@ char *argv[];
 
   printf("using %s port: [%o]\n", (userport ? "user-specified" : "default"), p_data);
   
-  /* parse source and destination file specs */
-  dofiles(argc, argv);
-
-
   if (argc < 2) {
-  printf("Usage: VGET usbfile {local} <-pxxx>\n");
+  printf("Usage: VGET usbfile {usbfile} ... {local} <-k> <-pxxx>\n");
+    printf("\tusbfile may use * and ? wild cards\n");
     printf("\tlocal is local drive and/or filespec\n");
+    printf("\t-k to verify each copy\n");
+    printf("\t-s to show USB statistics at exit\n");
     printf("\txxx is USB optional port in octal (default is %o)\n", VDATA);
   }
   else if (vinit() == -1) {
@@ -285,7 +365,27 @@ char *argv[];
   else if (vfind_disk() == -1) {
     printf("No flash drive found!\n");
   }
-  else
-    /* all is good - execute single file copy */
-    vcget(srcfile, destfile);
+  /* parse source and destination file specs */
+  else if (dofiles(argc, argv) < 1)
+    printf("No matching files\n");
+  else if ((nlist.nl_n > 1) && (destspec[index(destspec, ":")+1] != NUL))
+    printf("Destination must be a drive when copying several files\n");
+  else {
+    /* all is good - copy the file(s) in this session */
+    if (f_verify)
+      crcini();
+    for (i=0, s=names; i<nlist.nl_n; i++, s+=strlen(s)+1) {
+#ifndef HDOS
+      /* check for ^C */
+      CtlCk();
+#endif
+      strncpy(srcfile, s, FSLEN-1);
+      dstname(srcfile);
+      vcget(srcfile, destfile);
+    }
+    if (nlist.nl_n > 1)
+      printf("\n%d Files\n", nlist.nl_n);
+  }
+  if (f_stats)
+    vstats();
 }
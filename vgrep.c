@@ -0,0 +1,311 @@
+/********************************************************
+** vgrep - Version 4.3 for CP/M and HDOS
+**
+** This program searches files on the USB flash drive for
+** a string, without copying them to a local disk.
+**
+** Usage: vgrep string file {file} ... {-pxxx}
+**
+**    'string' is the text to look for; case is ignored.
+**    'file' is the name of a file on the USB drive, or a
+**    pattern using the "*" and "?" wild cards, which is
+**    matched against the USB directory.
+**
+**    switches:
+**      -s to show USB transfer statistics at exit
+**      -pxxx to specify octal port (default is 0261)
+**
+** Each line containing the string is shown as
+**
+**    FILE.EXT:line: text
+**
+** All the files are searched in a single session with the
+** device and nothing is written to the local disk. Each file
+** is read in large blocks with a single RDF per block, and
+** the search itself is done by the assembly routines in
+** BMSRCH, which skip over most of the text rather than
+** comparing at every position.
+**
+** Compiled with Software Toolworks C/80 V. 3.1 with support for
+** floats and longs.  Typical link statement:
+**
+** L80 vgrep,bmsrch,vinc,vutil,pio,fprintf,seek,flibrary/s,stdlib/s,clibrary/s,vgrep/n/e
+**
+** Our convention is to save all files with CP/M style
+** line endings (CR-LF). The HDOS version of C/80 is picky
+** and wants to see just LF (which is the HDOS standard line ending,
+** therefore the CR characters must be stripped out before compilation.
+** A separate STRIP.C program provides this capability.
+**
+** 18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+
+/* ensure globals live here */
+#define EXTERN
+#include "vutil.h"
+#include "vinc.h"
+
+#define BUFFSIZE  2048  /* bytes read per RDF */
+#define CARRY   128     /* tail of previous block kept */
+#define MAXPAT  64      /* longest search string */
+#define FSLEN   20
+#define NAMBUF  2048    /* space for names of files to search */
+
+/* the carried-over tail of the last block, then the
+** new block, are searched together so that matches
+** that straddle two blocks are not missed.
+*/
+char rwbuffer[CARRY+BUFFSIZE];
+
+/* the search string (upper case) */
+char pattern[MAXPAT+1];
+int patlen;
+
+/* names of the files to search, stored one after the
+** other as NUL-terminated strings.
+*/
+char names[NAMBUF];
+struct vnlist nlist;
+
+/* number of lines found */
+int nhits;
+
+/* show USB statistics at exit (-s) */
+int f_stats;
+
+/* dosw - process any switches on the command line.
+** Switches are preceded by "-".  If a numeric value
+** is given there should be no space, for example:
+** -p261 specifies port 261.  Switches must be to
+** the right of any file specifications on the
+** command line.
+*/
+dosw(argc, argv)
+int argc;
+char *argv[];
+{
+  int i;
+  char *s;
+
+  /* process right to left */
+  for (i=argc-1; i>2; i--) {
+    s = argv[i];
+    if (*s++ == '-') {
+      /* have a switch! */
+      switch (*s) {
+      case 'S':
+        f_stats = TRUE;
+        break;
+      case 'P':
+        ++s;
+        p_data = aotoi(s);
+        p_stat = p_data + 1;
+          break;
+      default:
+          printf("Invalid switch %c\n", *s);
+        break;
+      }
+    }
+  }
+}
+
+/* dofiles - build the list of files to search from the
+** arguments after the search string.  Plain names are
+** taken as given, while patterns are all matched against
+** one streamed "DIR" listing of the USB drive by
+** vlswild().
+**
+** Returns the number of files found, -1 on error.
+*/
+int dofiles(argc, argv)
+int argc;
+char *argv[];
+{
+  int i;
+  char *s;
+
+  vnlinit(&nlist, names, NAMBUF);
+  for (i=2; i<argc; i++) {
+    s = argv[i];
+    /* ignore switches and patterns */
+    if ((*s != '-') && !iswild(s) && (vnladd(&nlist, s) == -1))
+      return -1;
+  }
+
+  if (vlswild(&nlist, argc, argv, 2) == -1)
+    printf("Too many files - only %d searched\n", nlist.nl_n);
+  return nlist.nl_n;
+}
+
+/* showline - print the line of the block containing the
+** match at offset hit, preceded by file name and line
+** number. The line is cut short at the end of the block
+** (n); grepfile() holds back a line that runs on into the
+** next block, unless it is too long to carry over.
+** Returns the offset of the end of the line.
+*/
+int showline(name, lineno, buf, n, hit)
+char *name;
+long lineno;
+char *buf;
+int n, hit;
+{
+  int ls, le;
+  static char lstr[12];
+
+  for (ls=hit; (ls > 0) && (buf[ls-1] != '\n'); ls--)
+    ;
+  for (le=hit; (le < n) && (buf[le] != '\n'); le++)
+    ;
+  printf("%s:%s: ", name, ltodec(lineno, lstr));
+  while (ls < le) {
+    if ((buf[ls] != '\r') && (buf[ls] != 0x1A))
+      putchar(buf[ls]);
+    ++ls;
+  }
+  putchar('\n');
+  return le;
+}
+
+/* grepfile - search one file on the USB drive and show
+** each line containing the pattern.  Returns -1 if the
+** file can't be read.
+*/
+int grepfile(name)
+char *name;
+{
+  long len, lineno, lastln;
+  int carry, n, t, pos, hit, ls;
+  char *p;
+
+  if ((vdirf(name, &len) == -1) || (vropen(name) == -1)) {
+    printf("Unable to open %s\n", name);
+    return -1;
+  }
+
+  /* lineno is the line number at rwbuffer[pos] */
+  lineno = 1L;
+  lastln = 0L;
+  carry = 0;
+  while (len > 0L) {
+#ifndef HDOS
+    /* check for ^C */
+    CtlCk();
+#endif
+    n = (len > BUFFSIZE) ? BUFFSIZE : (int) len;
+    if (vread(rwbuffer + carry, n) == -1) {
+      printf("Error reading %s\n", name);
+      vclf();
+      return -1;
+    }
+    len -= n;
+    t = carry + n;
+
+    pos = 0;
+    while ((hit = bmsrch(rwbuffer + pos, t - pos)) != -1) {
+      hit += pos;
+      lineno += bmcnt(rwbuffer + pos, hit - pos, '\n');
+      /* the carried-over text may hold a line already shown */
+      if (lineno != lastln) {
+        /* a line that goes on into the next block is left
+        ** for the carry, to be shown whole from there.
+        */
+        for (ls=hit; (ls > 0) && (rwbuffer[ls-1] != '\n'); ls--)
+          ;
+        if ((len > 0L) && (t - ls <= CARRY) &&
+            (bmcnt(rwbuffer + hit, t - hit, '\n') == 0)) {
+          pos = ls;
+          break;
+        }
+        pos = showline(name, lineno, rwbuffer, t, hit);
+        lastln = lineno;
+        ++nhits;
+      }
+      else
+        pos = hit + 1;
+      if (pos >= t)
+        break;
+    }
+
+    /* carry over the unfinished last line, or at least
+    ** enough of it to catch a match across the blocks.
+    */
+    for (carry=0, p=rwbuffer+t; (carry < CARRY) && (p > rwbuffer) &&
+         (*(p-1) != '\n'); carry++, p--)
+      ;
+    if (carry < patlen - 1)
+      carry = (t < patlen - 1) ? t : patlen - 1;
+    if (pos < t - carry)
+      lineno += bmcnt(rwbuffer + pos, t - carry - pos, '\n');
+    else
+      /* keep carried text up to the last shown line */
+      carry = t - pos;
+    for (n=0; n<carry; n++)
+      rwbuffer[n] = rwbuffer[t - carry + n];
+  }
+  vclf();
+  return 0;
+}
+
+main(argc,argv)
+int argc;
+char *argv[];
+{
+  int i, userport;
+  char *s;
+
+  printf("VGREP v%s, ", VERSION);
+
+  /* Set default values */
+  p_data = VDATA;
+  p_stat = VSTAT;
+
+  /* set globals 'os' and 'osver' */
+  getosver();
+
+	/* check if user has a file specifying the port. For
+	** HDOS we can provide the location of this program executable
+	** but for CP/M we can only suggest looking on A:
+	*/
+#ifdef HDOS
+	userport = chkport("SY0:");
+#else
+	userport = chkport("A:");
+#endif
+
+  /* process any switches and set defaults */
+  dosw(argc, argv);
+
+  printf("using %s port: [%o]\n", (userport ? "user-specified" : "default"), p_data);
+
+  if (argc < 3) {
+    printf("Usage: VGREP string usbfile {usbfile} ... <-pxxx>\n");
+    printf("\tusbfile may use * and ? wild cards\n");
+    printf("\t-s to show USB statistics at exit\n");
+    printf("\txxx is USB optional port in octal (default is %o)\n", VDATA);
+  }
+  else if (((patlen = strlen(argv[1])) == 0) || (patlen > MAXPAT)) {
+    printf("Search string must be 1 to %d characters\n", MAXPAT);
+  }
+  else if (vinit() == -1) {
+    printf("Error initializing VDIP-1 device!\n");
+  }
+  else if (vfind_disk() == -1) {
+    printf("No flash drive found!\n");
+  }
+  else if (dofiles(argc, argv) < 1)
+    printf("No matching files\n");
+  else {
+    strcpy(pattern, argv[1]);
+    strupr(pattern);
+    bmprep(pattern, patlen);
+    for (i=0, s=names; i<nlist.nl_n; i++, s+=strlen(s)+1)
+      grepfile(s);
+    printf("\n%d line%s found in %d file%s\n", nhits,
+      (nhits == 1) ? "" : "s", nlist.nl_n, (nlist.nl_n == 1) ? "" : "s");
+  }
+  if (f_stats)
+    vstats();
+}
@@ -0,0 +1,674 @@
+/********************************************************
+** vimage - Version 4.3 for CP/M and HDOS
+**
+** This program backs up a whole local disk, track by track,
+** to a single image file on the USB flash drive, or restores
+** a disk from such an image.
+**
+** Usage: vimage d: image {-r} {-y} {-f} {-pxxx}
+**
+**    'd:' is the local drive (e.g. B: or SY1:) and 'image'
+**    the name of the image file on the USB drive, for
+**    example DISK1.IMG or BOOT.H8D.
+**
+**    switches:
+**      -r to restore the disk from the image (default is
+**         to back up the disk to the image)
+**      -y don't ask before overwriting the disk
+**      -f write the whole image, not just changed tracks
+**      -s to show USB transfer statistics at exit
+**      -pxxx to specify octal port (default is 0261)
+**
+** The disk is read (or written) through the BIOS under CP/M,
+** so every track is copied including the system tracks, and
+** a whole track is moved to or from the USB drive in each
+** transfer. The image is one file opened once, so the copy
+** is a single long sequential transfer with no per-file
+** overhead.
+**
+** Under CP/M 2.2 the BIOS is called through its jump table;
+** under CP/M 3 through BDOS function 50. The disk layout is
+** taken from the drive's DPB. Each track is stored in
+** physical sector order (the skew table from SECTRAN is
+** undone), so images of soft-sectored disks are the usual
+** raw .IMG layout.
+**
+** Under HDOS the device itself (e.g. SY1:) is opened and
+** read or written sequentially, which gives the sectors in
+** order - the .H8D layout for H17 disks.
+**
+** Each backup also saves a CRC-32 for every track in a map
+** file alongside the image (DISK1.MAP for DISK1.IMG). When
+** the image and map are there from an earlier backup of the
+** same disk, every track is still read and checksummed but
+** only the tracks that have changed are written, each one
+** seeked to its place in the existing image.
+**
+** Compiled with Software Toolworks C/80 V. 3.1 with support for
+** floats and longs.  Typical link statement:
+**
+** L80 vimage,vcrc,crc,vfile,vinc,vutil,pio,fprintf,seek,flibrary/s,stdlib/s,clibrary/s,vimage/n/e
+**
+** Our convention is to save all files with CP/M style
+** line endings (CR-LF). The HDOS version of C/80 is picky
+** and wants to see just LF (which is the HDOS standard line ending,
+** therefore the CR characters must be stripped out before compilation.
+** A separate STRIP.C program provides this capability.
+**
+** 18 October 2026
+** 18 October 2026 - per-track checksum map for incremental
+**                   backups
+**
+********************************************************/
+#include "fprintf.h"
+
+/* ensure globals live here */
+#define EXTERN
+#include "vutil.h"
+#include "vinc.h"
+#include "vfile.h"
+#include "vcrc.h"
+
+#define FSLEN   20
+
+#ifdef HDOS
+#define TRKSIZE 2560    /* H17 track: 10 sectors of 256 */
+#define MAXTRK  160     /* most tracks in a track map */
+#else
+/* BIOS function numbers */
+#define B_SELDSK  9
+#define B_SETTRK  10
+#define B_SETSEC  11
+#define B_SETDMA  12
+#define B_READ    13
+#define B_WRITE   14
+#define B_SECTRAN 16
+#define B_SETBNK  28
+
+/* CP/M disk parameter block */
+struct dpb {
+  unsigned dspt;        /* 128 byte records per track */
+  char dbsh;            /* block shift */
+  char dblm;            /* block mask */
+  char dexm;            /* extent mask */
+  unsigned ddsm;        /* highest block number */
+  unsigned ddrm;        /* highest directory entry */
+  char dal0, dal1;      /* directory allocation */
+  unsigned dcks;        /* check vector size */
+  unsigned doff;        /* reserved tracks */
+  char dpsh;            /* physical shift (CP/M 3) */
+  char dphm;            /* physical mask (CP/M 3) */
+};
+#endif
+
+/* switches */
+int f_restore, f_yes, f_full;
+
+char drive[FSLEN];      /* local drive */
+char image[FSLEN];      /* USB image file */
+char mapname[FSLEN];    /* USB track map file */
+
+char *trkbuf;           /* one track */
+unsigned trklen;        /* bytes per track */
+int ntrk;               /* number of tracks */
+
+char *trkmap;           /* CRC-32 of each track, C32LEN bytes each */
+int maxmap;             /* tracks trkmap has room for */
+
+#ifndef HDOS
+int drvnum;             /* drive 0 = A: */
+unsigned xlt;           /* skew table address */
+int spt;                /* sectors per track */
+unsigned secsz;         /* bytes per sector */
+int *secidx;            /* track buffer slot for each sector */
+int secbase;            /* lowest physical sector number */
+#endif
+
+/* show USB statistics at exit (-s) */
+int f_stats;
+
+/* dosw - process any switches on the command line.
+** Switches are preceded by "-".  If a numeric value
+** is given there should be no space, for example:
+** -p261 specifies port 261.  Switches must be to
+** the right of the drive and image names.
+*/
+dosw(argc, argv)
+int argc;
+char *argv[];
+{
+  int i;
+  char *s;
+
+  /* process right to left */
+  for (i=argc-1; i>2; i--) {
+    s = argv[i];
+    if (*s++ == '-') {
+      /* have a switch! */
+      switch (*s) {
+      case 'R':
+        f_restore = TRUE;
+        break;
+      case 'Y':
+        f_yes = TRUE;
+        break;
+      case 'F':
+        f_full = TRUE;
+        break;
+      case 'S':
+        f_stats = TRUE;
+        break;
+      case 'P':
+        ++s;
+        p_data = aotoi(s);
+        p_stat = p_data + 1;
+          break;
+      default:
+          printf("Invalid switch %c\n", *s);
+        break;
+      }
+    }
+  }
+}
+
+#ifndef HDOS
+/* bcall - call the routine at addr with registers BC and
+** DE set. Returns HL if hlret is TRUE, else A.
+*/
+int bcall(addr, bc, de, hlret)
+int addr, bc, de, hlret;
+{
+#asm
+        LXI     H,2
+        DAD     SP
+        MOV     A,M             ; hlret
+        STA     BCFLG
+        INX     H
+        INX     H
+        MOV     E,M             ; DE
+        INX     H
+        MOV     D,M
+        INX     H
+        MOV     C,M             ; BC
+        INX     H
+        MOV     B,M
+        INX     H
+        MOV     A,M             ; addr
+        INX     H
+        MOV     H,M
+        MOV     L,A
+        SHLD    BCADR
+        LXI     H,BCBACK
+        PUSH    H
+        LHLD    BCADR
+        PCHL
+BCBACK: STA     BCAREG
+        LDA     BCFLG
+        ORA     A
+        RNZ                     ; result in HL
+        LDA     BCAREG
+        MOV     L,A
+        MVI     H,0
+        RET
+BCFLG:  DS      1
+BCAREG: DS      1
+BCADR:  DS      2
+#endasm
+}
+
+/* bios - call BIOS function fn with A, BC and DE as
+** given. Returns HL if hlret is TRUE (SELDSK, SECTRAN),
+** otherwise A.
+*/
+int bios(fn, a, bc, de, hlret)
+int fn, a, bc, de, hlret;
+{
+  int *wboot;
+  static char pb[8];
+
+  if (osver >= 0x30) {
+    /* CP/M 3 - BDOS function 50 with a BIOS parameter block */
+    pb[0] = fn;
+    pb[1] = a;
+    pb[2] = bc & 0xFF;
+    pb[3] = (bc >> 8) & 0xFF;
+    pb[4] = de & 0xFF;
+    pb[5] = (de >> 8) & 0xFF;
+    pb[6] = pb[7] = 0;
+    return bcall(5, 50, pb, hlret);
+  }
+  /* CP/M 2.2 - straight through the jump table */
+  wboot = 1;
+  return bcall(*wboot - 3 + fn * 3, bc, de, hlret);
+}
+
+/* dskinit - find the layout of the drive and set up for
+** track I/O. Returns -1 if the drive can't be used.
+*/
+int dskinit()
+{
+  struct dpb *d;
+  unsigned dph, *p;
+  int s;
+  long recs;
+
+  drvnum = toupper(drive[0]) - 'A';
+  if ((drvnum < 0) || (drvnum > 15) || (drive[1] != ':'))
+    return -1;
+
+  /* have the BDOS log in the drive, then get its DPB */
+  bdos(14, drvnum);
+  d = bdoshl(31, 0);
+
+  if ((dph = bios(B_SELDSK, 0, drvnum, 1, TRUE)) == 0)
+    return -1;
+  p = dph;
+  xlt = *p;
+
+  if (osver >= 0x30) {
+    spt = d->dspt >> d->dpsh;
+    secsz = 128 << d->dpsh;
+    /* DMA is in the TPA bank */
+    bios(B_SETBNK, 1, 0, 0, FALSE);
+  }
+  else {
+    spt = d->dspt;
+    secsz = 128;
+  }
+  trklen = spt * secsz;
+
+  /* data tracks hold (DSM+1) blocks of 2^BSH records */
+  recs = ((long) d->ddsm + 1L) << d->dbsh;
+  ntrk = d->doff + (int) ((recs + d->dspt - 1) / d->dspt);
+
+  /* work out where each logical sector goes in the
+  ** track buffer so the image is in physical order.
+  */
+  if ((secidx = alloc(spt * 2)) == 0)
+    return -1;
+  for (s=0; s<spt; s++) {
+    secidx[s] = bios(B_SECTRAN, 0, s, xlt, TRUE);
+    if ((s == 0) || (secidx[s] < secbase))
+      secbase = secidx[s];
+  }
+  for (s=0; s<spt; s++)
+    secidx[s] -= secbase;
+  return 0;
+}
+
+/* trkio - read (wr FALSE) or write (wr TRUE) track t
+** to or from the track buffer. Returns -1 on error.
+*/
+int trkio(t, wr)
+int t, wr;
+{
+  int s;
+
+  bios(B_SETTRK, 0, t, 0, FALSE);
+  for (s=0; s<spt; s++) {
+    bios(B_SETSEC, 0, secidx[s] + secbase, 0, FALSE);
+    bios(B_SETDMA, 0, trkbuf + secidx[s] * secsz, 0, FALSE);
+    if (wr) {
+      /* the last write of a track is flagged as a
+      ** directory write, so a deblocking BIOS flushes
+      ** its buffer.
+      */
+      if (bios(B_WRITE, 0, (s == spt-1) ? 1 : 0, 0, FALSE) != 0)
+        return -1;
+    }
+    else if (bios(B_READ, 0, 0, 0, FALSE) != 0)
+      return -1;
+  }
+  return 0;
+}
+#endif
+
+/* yesno - ask a question, returns TRUE for Y */
+int yesno(q)
+char *q;
+{
+  int c;
+
+  printf("%s (Y/N)? ", q);
+#ifdef HDOS
+  c = getchar();
+#else
+  c = bdos(1, 0);
+#endif
+  printf("\n");
+  return toupper(c) == 'Y';
+}
+
+/* mapfile - form the name of the track map from the
+** image name, e.g. DISK1.IMG gives DISK1.MAP.
+*/
+mapfile()
+{
+  int i;
+
+  strcpy(mapname, image);
+  if ((i = index(mapname, ".")) != -1)
+    mapname[i] = NUL;
+  strcat(mapname, ".MAP");
+}
+
+/* getmap - read the track checksums saved by the last
+** backup. This is done before the image is opened since
+** only one file may be open on the USB drive. Returns
+** the number of tracks in the map, -1 if there is no
+** usable map.
+*/
+int getmap()
+{
+  struct vfile *f;
+  int n;
+  /* not linebuff: vfgets() may refill its buffer part way
+  ** through a line, and the prompt is read into linebuff.
+  */
+  static char line[128];
+
+  if ((f = vfopen(mapname, "r")) == 0)
+    return -1;
+  n = 0;
+  while (vfgets(line, 128, f) != 0) {
+    if (n >= maxmap) {
+      n = -1;
+      break;
+    }
+    strncpy(trkmap + n * C32LEN, line, C32LEN-1);
+    trkmap[n * C32LEN + C32LEN-1] = NUL;
+    ++n;
+  }
+  vfclose(f);
+  return n;
+}
+
+/* putmap - save the checksums of the first n tracks.
+** Returns -1 on error.
+*/
+int putmap(n)
+int n;
+{
+  struct vfile *f;
+  int t;
+
+  if ((f = vfopen(mapname, "w")) == 0)
+    return -1;
+  for (t=0; t<n; t++) {
+    vfputs(trkmap + t * C32LEN, f);
+    vfputs("\r\n", f);
+  }
+  return vfclose(f);
+}
+
+/* backup - copy the disk to the image file, a track at
+** a time. If the image and its track map are left from
+** an earlier backup of the same size, only the tracks
+** whose checksums have changed are written, each at its
+** own offset in the image. Returns -1 on error.
+*/
+int backup()
+{
+  int t, n, rc, incr, nmap, nsame;
+  long size, len, pos;
+  char s32[C32LEN], s16[C16LEN];
+  static char sstr[15];
+#ifdef HDOS
+  int chan;
+
+  if ((chan = fopen(drive, "rb")) == 0) {
+    printf("Unable to open %s\n", drive);
+    return -1;
+  }
+#endif
+
+  incr = FALSE;
+  if (!f_full && (vdirf(image, &len) != -1) && ((nmap = getmap()) > 0) &&
+      (len == (long) nmap * trklen)) {
+    incr = TRUE;
+#ifndef HDOS
+    incr = (nmap == ntrk);
+#endif
+  }
+  if (!incr) {
+    /* replace any old image rather than append to it */
+    nmap = 0;
+    vdlf(image);
+  }
+  settd(FALSE);
+  if (vwopen(image) == -1) {
+    printf("Unable to create %s\n", image);
+#ifdef HDOS
+    fclose(chan);
+#endif
+    return -1;
+  }
+
+  rc = 0;
+  size = 0L;
+  nsame = 0;
+  /* an image opened for write is positioned at its end */
+  pos = incr ? len : 0L;
+  for (t=0; ; t++) {
+#ifdef HDOS
+    if ((n = read(chan, trkbuf, trklen)) <= 0)
+      break;
+#else
+    /* check for ^C */
+    CtlCk();
+    if (t >= ntrk)
+      break;
+    if (trkio(t, FALSE) == -1) {
+      printf("\nError reading track %d\n", t);
+      rc = -1;
+      break;
+    }
+    n = trklen;
+#endif
+    crcbeg();
+    crcupd(trkbuf, n);
+    crcend(s32, s16);
+    if ((t < nmap) && (n == trklen) && (strcmp(s32, trkmap + t * C32LEN) == 0)) {
+      ++nsame;
+      printf("\rTrack %d", t);
+      continue;
+    }
+    if ((pos != (long) t * trklen) && (vseek((long) t * trklen) == -1)) {
+      printf("\nError seeking in %s\n", image);
+      rc = -1;
+      break;
+    }
+    if (vwrite(trkbuf, n) == -1) {
+      printf("\nError writing to VDIP device\n");
+      rc = -1;
+      break;
+    }
+    pos = (long) t * trklen + n;
+    size += n;
+    if (t < maxmap)
+      strcpy(trkmap + t * C32LEN, s32);
+    printf("\rTrack %d", t);
+  }
+  vclose(image);
+#ifdef HDOS
+  fclose(chan);
+#endif
+  commafmt(size, sstr, 15);
+  printf("\r%s --> USB:%s  %d tracks, %s bytes written", drive, image, t, sstr);
+  if (incr)
+    printf(", %d unchanged", nsame);
+  printf("\n");
+
+  /* a map that doesn't match the image would be worse
+  ** than none.
+  */
+  if ((rc == -1) || (t > maxmap) || (putmap(t) == -1)) {
+    vdlf(mapname);
+    if (rc != -1)
+      printf("Unable to write %s\n", mapname);
+  }
+  return rc;
+}
+
+/* restore - copy the image file back to the disk, a
+** track at a time. Returns -1 on error.
+*/
+int restore()
+{
+  int t, n, rc;
+  long len;
+  static char q[60];
+#ifdef HDOS
+  int chan;
+#endif
+
+  if (vdirf(image, &len) == -1) {
+    printf("Unable to open %s\n", image);
+    return -1;
+  }
+#ifndef HDOS
+  if (len != (long) ntrk * trklen) {
+    printf("%s does not match the size of drive %s\n", image, drive);
+    return -1;
+  }
+#endif
+
+  strcpy(q, "All data on ");
+  strcat(q, drive);
+  strcat(q, " will be replaced. Continue");
+  if (!f_yes && !yesno(q))
+    return -1;
+
+#ifdef HDOS
+  if ((chan = fopen(drive, "wb")) == 0) {
+    printf("Unable to open %s\n", drive);
+    return -1;
+  }
+#endif
+  if (vropen(image) == -1) {
+    printf("Unable to open %s\n", image);
+#ifdef HDOS
+    fclose(chan);
+#endif
+    return -1;
+  }
+
+  rc = 0;
+  for (t=0; len > 0L; t++) {
+#ifndef HDOS
+    /* check for ^C */
+    CtlCk();
+#endif
+    n = (len > trklen) ? trklen : (int) len;
+    if (vread(trkbuf, n) == -1) {
+      printf("\nError reading %s\n", image);
+      rc = -1;
+      break;
+    }
+    len -= n;
+#ifdef HDOS
+    if (write(chan, trkbuf, n) == -1) {
+#else
+    if (trkio(t, TRUE) == -1) {
+#endif
+      printf("\nError writing track %d\n", t);
+      rc = -1;
+      break;
+    }
+    printf("\rTrack %d", t);
+  }
+  vclose(image);
+#ifdef HDOS
+  fclose(chan);
+#endif
+  printf("\rUSB:%s --> %s  %d tracks\n", image, drive, t);
+  return rc;
+}
+
+main(argc,argv)
+int argc;
+char *argv[];
+{
+  int userport;
+#ifndef HDOS
+  int curdrv;
+#endif
+
+  printf("VIMAGE v%s, ", VERSION);
+
+  /* Set default values */
+  p_data = VDATA;
+  p_stat = VSTAT;
+
+  /* set globals 'os' and 'osver' */
+  getosver();
+
+	/* check if user has a file specifying the port. For
+	** HDOS we can provide the location of this program executable
+	** but for CP/M we can only suggest looking on A:
+	*/
+#ifdef HDOS
+	userport = chkport("SY0:");
+#else
+	userport = chkport("A:");
+#endif
+
+  /* process any switches and set defaults */
+  dosw(argc, argv);
+
+  printf("using %s port: [%o]\n", (userport ? "user-specified" : "default"), p_data);
+
+  if ((argc < 3) || (index(argv[1], ":") == -1)) {
+    printf("Usage: VIMAGE drive: usbimage <-r> <-y> <-f> <-pxxx>\n");
+    printf("\t-r to restore the drive from the image\n");
+    printf("\t-f to write every track, not just those changed\n");
+    printf("\t-y to overwrite the drive without asking\n");
+    printf("\t-s to show USB statistics at exit\n");
+    printf("\txxx is USB optional port in octal (default is %o)\n", VDATA);
+    return;
+  }
+
+  strncpy(drive, argv[1], FSLEN-1);
+  strncpy(image, argv[2], FSLEN-5);
+  if (index(image, ".") == -1)
+#ifdef HDOS
+    strcat(image, ".H8D");
+#else
+    strcat(image, ".IMG");
+#endif
+
+  mapfile();
+#ifdef HDOS
+  trklen = TRKSIZE;
+  maxmap = MAXTRK;
+#else
+  curdrv = bdos(25, 0);
+  if (dskinit() == -1) {
+    printf("Unable to use drive %s\n", drive);
+    return;
+  }
+  maxmap = ntrk;
+#endif
+
+  if (((trkbuf = alloc(trklen)) == 0) ||
+      ((trkmap = alloc(maxmap * C32LEN)) == 0))
+    printf("Not enough memory for the track buffers\n");
+  else if (vinit() == -1)
+    printf("Error initializing VDIP-1 device!\n");
+  else if (vfind_disk() == -1)
+    printf("No flash drive found!\n");
+  else if (f_restore)
+    restore();
+  else {
+    crcini();
+    backup();
+  }
+
+#ifndef HDOS
+  /* let the BDOS forget what it knew about the disks */
+  bdos(13, 0);
+  bdos(14, curdrv);
+#endif
+  if (f_stats)
+    vstats();
+}
@@ -23,6 +23,41 @@
 ** interface, which would otherwise be impossible or impractical
 ** to implement on simple 8-bit hardware like the H-8.
 **
+** Instrumentation: when compiled with -qVSTATS=1 the
+** library counts the commands issued by class with the
+** time each class took, data bytes read and written,
+** status-port polls while moving data and while waiting
+** for a reply, time spent waiting for the prompt and
+** timeouts. vstats()
+** prints the summary; the utilities call it for "-s".
+** Without VSTATS none of this code is compiled in.
+**
+** Tracing: with -qVTRACE=1 (which implies VSTATS) every
+** byte sent and received is also recorded, with the start
+** of each command, its end (the prompt), timeouts and the
+** clock tick of each, in a ring buffer of VTRSIZE bytes
+** holding the latest VTRSIZE/4 events. vtrdump() writes
+** the buffer to a local or USB file, which vstats() does to
+** VTRFILE; host/vtrace.c turns it into per-command timings.
+**
+** Several devices: every routine has a "vd" form (vdinit(),
+** vdropen(), vdread() ...) taking a struct vdev pointer
+** first, which holds the ports, line buffer, mode and
+** counts for one VDIP1, so one program can drive two or
+** more boards on different ports. vdopen() sets one up.
+** The original names (vinit(), vropen(), vread() ...) work
+** on the default device, vdflt, which takes its ports from
+** p_data and p_stat and uses linebuff, so existing
+** programs are unchanged. The VSTATS figures cover all
+** devices together, but each device keeps the class and
+** start of its own command in progress, so one device may
+** be given a command while another's is outstanding (as
+** vdmwrite() and vdrsend() do) and each is charged its own
+** time. Time in which two devices are busy at once counts
+** for both, so the times by class can add up to more than
+** the elapsed time. VTRACE events do not say which device
+** they are for.
+**
 ** Usage Notes:
 **
 ** The typical calling sequence is as follows: vinit() is
@@ -46,15 +81,127 @@
 **  Glenn Roberts
 **  31 January 2022
 **
+** 18 October 2026 - added the vd routines and struct vdev
+** for more than one VDIP1; the original routines are now
+** wrappers for the default device.
+**
+** 18 October 2026 - vdread() split into vdrsend() and
+** vdrget(), so that one device can be fetching a block
+** while the program writes to another.
+**
+** 18 October 2026 - added vdapoff() for appending to a
+** copy of a growing local file.
+**
+** 18 October 2026 - VSTATS keeps the command in progress
+** for each device, for the figures of two-device copies.
+**
+** 18 October 2026 - added vdlswild() to gather the files
+** matching wild card arguments.
+**
 ********************************************************/
 #include "fprintf.h"
 #include "vutil.h"
 #include "vinc.h"
 
+#ifdef VTRACE
+/* the trace is marked out using the VSTATS hooks */
+#ifndef VSTATS
+#define VSTATS  1
+#endif
+
+#ifndef VTRSIZE
+#define VTRSIZE 4096    /* bytes, 4 per event */
+#endif
+#define VTRFILE "VTRACE.TRC"
+#define VTRHDR  16
+
+/* event types; each event is type, data, tick (LSB first) */
+#define VT_OUT  'O'     /* byte sent */
+#define VT_IN   'I'     /* byte received */
+#define VT_CMD  'C'     /* command of class data started */
+#define VT_END  'E'     /* command ended */
+#define VT_TMO  'T'     /* timeout */
+
+char vtrbuf[VTRSIZE];   /* the ring */
+unsigned vtrpos;        /* next event goes here */
+int vtrwrp;             /* TRUE once the ring has filled */
+int vtrhz;              /* tickhz(), kept for vtrclk() */
+int vtroff;             /* TRUE while the dump is written */
+#endif
+
+/* command classes passed to vdcmd() */
+#define VS_RDF  0
+#define VS_WRF  1
+#define VS_OPN  2       /* OPR, OPW */
+#define VS_SEK  3
+#define VS_CLF  4
+#define VS_DIR  5       /* DIR, DIRT */
+#define VS_OTH  6
+#define VS_N    7
+
+#ifdef VSTATS
+#define VSNAMES "RDF    WRF    OPR/OPWSEK    CLF    DIR    other  "
+
+long vsncmd[VS_N];      /* commands issued */
+long vstcmd[VS_N];      /* ticks from command to prompt */
+long vsbin, vsbout;     /* data bytes read and written */
+long vsrxp, vstxp;      /* RXF and TXE status polls for data */
+long vsrwp;             /* RXF polls waiting for a reply */
+long vstprm;            /* ticks spent in vprompt() */
+long vst0;              /* start of session */
+int vstmo;              /* timeouts */
+#endif
+
+
+/********************************************************
+**
+** vdopen
+**
+** Set up the device structure vd for a VDIP1 whose data
+** port is port (the status port is the next one up), using
+** line as its 128 byte line buffer. The counts are
+** cleared. This only fills in vd; vdinit() must then be
+** called to talk to the device.
+**
+********************************************************/
+int vdopen(vd, port, line)
+struct vdev *vd;
+int port;
+char *line;
+{
+  vd->vd_data = port;
+  vd->vd_stat = port + 1;
+  vd->vd_line = line;
+  vd->vd_mode = VDM_NONE;
+  vd->vd_ncmd = vd->vd_nin = vd->vd_nout = 0L;
+  vd->vd_ntmo = 0;
+  vd->vd_wpend = FALSE;
+  vd->vd_scls = -1;
+}
+
+/********************************************************
+**
+** vdcmd
+**
+** Count a command of class c (VS_RDF etc.) on device vd,
+** and pass it on to the instrumentation when the library
+** is compiled with VSTATS.
+**
+********************************************************/
+int vdcmd(vd, c)
+struct vdev *vd;
+int c;
+{
+  ++vd->vd_ncmd;
+#ifdef VSTATS
+  vscmd(vd, c);
+#endif
+}
+
 
 /********************************************************
 **
-** str_send
+** vdsend, str_send
 **
 ** Output a null-terminated string to the VDIP device.
 ** If you want a carriage return to be sent it must be
@@ -65,7 +212,8 @@
 **    -1  I/O error
 **
 ********************************************************/
-int str_send(s)
+int vdsend(vd, s)
+struct vdev *vd;
 char *s;
 {
   char *c;
@@ -77,14 +225,14 @@ char *s;
   rc = 0;
 
   for (c=s; ((*c!=0) && (rc!=-1)); c++)
-    rc = out_vwait(*c, MAXWAIT);
+    rc = vdoutw(vd, *c, MAXWAIT);
   
   return rc;
 }
 
 /********************************************************
 **
-** str_rdw
+** vdrdw, str_rdw
 **
 ** "Read with wait" - Used to read a string from the VDIP
 ** device but detect hung conditions by monitoring the time.
@@ -98,7 +246,8 @@ char *s;
 **    -1 if read timed out.
 **
 ********************************************************/
-int str_rdw(s, tchar)
+int vdrdw(vd, s, tchar)
+struct vdev *vd;
 char *s;
 char tchar;
 {
@@ -110,7 +259,7 @@ char tchar;
 	slen = 0;
 
   do {
-    if((c = in_vwait(MAXWAIT)) == -1)
+    if((c = vdinw(vd, MAXWAIT)) == -1)
       timedout = TRUE;
     else {
       /* got a byte, check for end */
@@ -134,7 +283,7 @@ char tchar;
 
 /********************************************************
 **
-** in_v
+** vdin, in_v
 **
 ** Read a character from the VDIP1 
 **
@@ -146,14 +295,18 @@ char tchar;
 ** conditions!
 **
 ********************************************************/
-int in_v()
+int vdin(vd)
+struct vdev *vd;
 {
   int b;
   
   /* check for Data Ready */
-  if ((inp(p_stat) & VRXF) != 0) {
+  if ((inp(vd->vd_stat) & VRXF) != 0) {
     /* read the character from the port and return it */
-    b = inp(p_data);
+    b = inp(vd->vd_data);
+#ifdef VTRACE
+    vtrec(VT_IN, b);
+#endif
     return b;
   }
   else
@@ -163,26 +316,39 @@ int in_v()
 
 /********************************************************
 **
-** out_v
+** vdout, out_v
 **
 ** Send a character to the VDIP1 via the specified port.
 ** Performs I/O handshaking with the VDIP1 device.
 **
 ********************************************************/
-int out_v(c)
+int vdout(vd, c)
+struct vdev *vd;
 char c;
 {
+#ifdef VSTATS
+  unsigned w;
+
+  w = 0;
+  while ((inp(vd->vd_stat) & VTXE) == 0)
+    ++w;
+  vstxp += w;
+#else
   /* Wait for ok to transmit (VTXE high) */
-  while ((inp(p_stat) & VTXE) == 0)
+  while ((inp(vd->vd_stat) & VTXE) == 0)
     ;
+#endif
+#ifdef VTRACE
+  vtrec(VT_OUT, c);
+#endif
   /* OK to transmit the character */
-  outp(p_data,c);
+  outp(vd->vd_data,c);
 }
 
 
 /********************************************************
 **
-** in_vwait
+** vdinw, in_vwait
 **
 ** "Input with Wait" - Input a character from the VDIP1 but 
 ** detect hung conditions by monitoring the time. Wait no 
@@ -193,7 +359,8 @@ char c;
 **    -1 if timed out
 **
 ********************************************************/
-int in_vwait(t)
+int vdinw(vd, t)
+struct vdev *vd;
 int t;
 {
   /* start short duration timer */
@@ -201,23 +368,37 @@ int t;
   
   /* now wait for port activity or timeout */
   while (timer(0, 0)) {
+#ifdef VSTATS
+    ++vsrwp;
+#endif
     /* check for port activity and if so then read 
     ** the data, break out of the loop and return
     */
-    if (inp(p_stat) & VRXF)
-      return inp(p_data);
+    if (inp(vd->vd_stat) & VRXF)
+#ifdef VTRACE
+      return vtrin(inp(vd->vd_data));
+#else
+      return inp(vd->vd_data);
+#endif
   }
 
   /* if we fall through it means the number of specified
   ** seconds passed without input activity.  To indicate
   ** this timeout error we return -1
   */
+  ++vd->vd_ntmo;
+#ifdef VSTATS
+  ++vstmo;
+#endif
+#ifdef VTRACE
+  vtrec(VT_TMO, 0);
+#endif
   return -1;
 }
 
 /********************************************************
 **
-** out_vwait
+** vdoutw, out_vwait
 **
 ** Send a character to the VDIP1 via the specified port,
 ** but detect hung conditions by monitoring the time.
@@ -228,7 +409,8 @@ int t;
 **    -1  if timed out
 **
 ********************************************************/
-int out_vwait(c,t)
+int vdoutw(vd, c, t)
+struct vdev *vd;
 char c;
 int t;
 {
@@ -237,12 +419,18 @@ int t;
   
   /* now wait for port activity or timeout */
   while (timer(0, 0)) {
+#ifdef VSTATS
+    ++vstxp;
+#endif
     /* check for ok to transmit (VTXE high) and,
     ** if so, then transmit and break out of the
     ** loop with successful return.
     */
-    if (inp(p_stat) & VTXE) {
-      outp(p_data,c);
+    if (inp(vd->vd_stat) & VTXE) {
+#ifdef VTRACE
+      vtrec(VT_OUT, c);
+#endif
+      outp(vd->vd_data,c);
       return 0;
     }
   }
@@ -250,51 +438,66 @@ int t;
   ** seconds passed without input activity.  To indicate
   ** this timeout error we return -1
   */
+  ++vd->vd_ntmo;
+#ifdef VSTATS
+  ++vstmo;
+#endif
+#ifdef VTRACE
+  vtrec(VT_TMO, 0);
+#endif
   return -1;
 }
 
 
 /********************************************************
 **
-** vfind_disk
+** vdfind, vfind_disk
 **
 ** Determine if there is a flash drive available on the
 ** USB port. 
 **
 **
 ********************************************************/
-int vfind_disk()
+int vdfind(vd)
+struct vdev *vd;
 {
   /* If there is a drive available then a \r will cause 
   ** the prompt to come back, so simply send \r and 
   ** then test for a command prompt...
   */
-  str_send("\r");
+  vdcmd(vd, VS_OTH);
+  vdsend(vd, "\r");
   
-  return vprompt();
+  return vdprompt(vd);
 }
 
 /********************************************************
 **
-** vpurge
+** vdpurge, vpurge
 **
 ** Read all the pending data from the VDIP device and 
 ** throw it away.  Wait for up to 1 second each time
 ** before deciding we're done. 
 **
 ********************************************************/
-int vpurge()
+int vdpurge(vd)
+struct vdev *vd;
 {
   int c;
   
   do {
-    c = in_vwait(1);
+    c = vdinw(vd, 1);
   } while (c != -1);
+  /* running out of data here is not a timeout */
+  --vd->vd_ntmo;
+#ifdef VSTATS
+  --vstmo;
+#endif
 }
 
 /********************************************************
 **
-** vhandshake
+** vdhand, vhandshake
 **
 ** This routine checks to see if two-way communication with 
 ** the VDIP Command Monitor is working. It sends an ASCII 'E'
@@ -305,30 +508,35 @@ int vpurge()
 **    -1  Error, timed out or no response
 **
 ********************************************************/
-int vhandshake()
+int vdhand(vd)
+struct vdev *vd;
 {
   int rc;
   
+  vdcmd(vd, VS_OTH);
   /* Attempt to send an "E" */
-  if (str_send("E\r") == -1)
+  if (vdsend(vd, "E\r") == -1)
     /* time out on send! */
     rc = -1;
-  else if (str_rdw(linebuff, '\r') == -1)
+  else if (vdrdw(vd, vd->vd_line, '\r') == -1)
     /* time out on reading response! */
     rc = -1;
-  else if (strcmp(linebuff,"E") != 0)
+  else if (strcmp(vd->vd_line,"E") != 0)
     /* wrong response! */
     rc = -1;
   else
     /* success! */
     rc = 0;
+#ifdef VSTATS
+  vsend(vd);
+#endif
 
   return rc;
 }
 
 /********************************************************
 **
-** vinit
+** vdinit, vinit
 **
 ** Initialize the VDIP connection.
 **
@@ -342,23 +550,33 @@ int vhandshake()
 **    -1: Error
 **
 ********************************************************/
-int vinit()
+int vdinit(vd)
+struct vdev *vd;
 {
   int rc;
 
   rc = 0;
+  vd->vd_mode = VDM_NONE;
+  vd->vd_wpend = FALSE;
+#ifdef VSTATS
+  vst0 = ticks();
+  vd->vd_scls = -1;
+#endif
+#ifdef VTRACE
+  vtrhz = tickhz();
+#endif
   
   /*first try to talk to the device */
-  if (vsync() == -1)
+  if (vdsync(vd) == -1)
     rc = -1;
   else {
     /* initialization commands */
     
     /* ASCII mode (more friendly) */
-    rc = vipa();
+    rc = vdipa(vd);
     /* Close any open file */
     if (rc == 0)
-      rc = vclf();
+      rc = vdclf(vd);
   }
 
   return rc;
@@ -366,7 +584,39 @@ int vinit()
 
 /********************************************************
 **
-** vsync
+** vdsetup
+**
+** Set up vd for the VDIP1 at port, with line as its line
+** buffer (see vdopen()), initialize it and make sure a
+** flash drive is attached, saying which check failed on
+** the console. This is how a program brings up a second
+** VDIP1.
+**
+** Returns:
+**    0: Normal
+**    -1: Error
+**
+********************************************************/
+int vdsetup(vd, port, line)
+struct vdev *vd;
+int port;
+char *line;
+{
+  vdopen(vd, port, line);
+  if (vdinit(vd) == -1) {
+    printf("Error initializing VDIP-1 device at [%o]!\n", port);
+    return -1;
+  }
+  if (vdfind(vd) == -1) {
+    printf("No flash drive found on VDIP-1 at [%o]!\n", port);
+    return -1;
+  }
+  return 0;
+}
+
+/********************************************************
+**
+** vdsync, vsync
 **
 ** Flush the input buffer and attempt to handshake with
 ** the VDIP1 device.  This should put things in a known
@@ -377,7 +627,8 @@ int vinit()
 **    -1  can't sync with device
 **
 ********************************************************/
-int vsync()
+int vdsync(vd)
+struct vdev *vd;
 {
   int i, rc;
   
@@ -386,10 +637,10 @@ int vsync()
   /* try up to 3 times to sync */
   for (i=0; i<3; i++) {
     /* first purge any waiting data */
-    vpurge();
+    vdpurge(vd);
 
     /* now attempt two-way communication */
-    if (vhandshake()==0) {
+    if (vdhand(vd)==0) {
       /* we're talking! */
       rc = 0;
       break;
@@ -401,7 +652,7 @@ int vsync()
 
 /********************************************************
 **
-** vdirf
+** vddirf, vdirf
 **
 ** This is an interface to the Vinculum "DIR" command
 ** (Directory) for a specified file.
@@ -416,7 +667,8 @@ int vsync()
 **    -1: Error (most likely means file not found)
 **
 ********************************************************/
-int vdirf(s, len)
+int vddirf(vd, s, len)
+struct vdev *vd;
 char *s;
 long *len;
 {
@@ -425,26 +677,27 @@ long *len;
   static union u_fil flen;
 
   rc = 0;
+  vdcmd(vd, VS_DIR);
   
-  str_send("dir ");
-  str_send(s);
-  str_send("\r");
+  vdsend(vd, "dir ");
+  vdsend(vd, s);
+  vdsend(vd, "\r");
   
   /* first line is always blank, just read it */
-  str_rdw(linebuff, '\r');
+  vdrdw(vd, vd->vd_line, '\r');
   
   /* the result will either be the file name or
   ** "Command Failed". if the latter then return error.
   */
-  str_rdw(linebuff, '\r');
+  vdrdw(vd, vd->vd_line, '\r');
 
-  if (strcmp(linebuff, CFERROR) == 0) {
+  if (strcmp(vd->vd_line, CFERROR) == 0) {
     /* flag an error! */
     rc = -1;
   }
   else {
     /* skip over file name (to first blank) */
-    for (c=linebuff; ((*c!=' ') && (*c!=0)); c++)
+    for (c=vd->vd_line; ((*c!=' ') && (*c!=0)); c++)
       ;
     /* read file length as 4 hex values */
     gethexvals(c, 4, &flen.b[0]);
@@ -453,15 +706,51 @@ long *len;
     *len = flen.l;
     
     /* success - gobble up the prompt */
-    str_rdw(linebuff, '\r');
+    vdrdw(vd, vd->vd_line, '\r');
   }
+#ifdef VSTATS
+  vsend(vd);
+#endif
   
   return rc;
 }
 
 /********************************************************
 **
-** vdird
+** vdapoff, vapoff
+**
+** The offset at which to append to USB file s: its length,
+** backed up to the start of the last GROWSZ record, since
+** the local file grows a record (sector under HDOS) at a
+** time and that record may only have been partly filled
+** when it was copied before. If local file chan is shorter
+** than the USB copy it is not the file that copy was made
+** from, and the whole file must be copied again. chan is
+** read to find out and left at the start.
+**
+** Returns:
+**    offset to append at
+**    0 if the file must be copied from the start (or
+**      there is no USB copy)
+**
+********************************************************/
+long vdapoff(vd, s, chan)
+struct vdev *vd;
+char *s;
+int chan;
+{
+  long len;
+
+  if ((vddirf(vd, s, &len) == -1) || (len == 0L) ||
+      (lseekl(chan, len) == -1))
+    return 0L;
+  seek(chan, 0, 0);
+  return ((len - 1L) / GROWSZ) * GROWSZ;
+}
+
+/********************************************************
+**
+** vddird, vdird
 **
 ** This is an interface to the Vinculum "DIRT" command
 ** (Directory) for a specified file.
@@ -476,7 +765,8 @@ long *len;
 **    -1: Error (most likely means file not found)
 **
 ********************************************************/
-int vdird(s, udate, utime)
+int vddird(vd, s, udate, utime)
+struct vdev *vd;
 char *s;
 unsigned *udate, *utime;
 {
@@ -486,10 +776,11 @@ unsigned *udate, *utime;
   static char dates[10];
   
   rc = 0;
+  vdcmd(vd, VS_DIR);
   
-  str_send("dirt ");
-  str_send(s);
-  str_send("\r");
+  vdsend(vd, "dirt ");
+  vdsend(vd, s);
+  vdsend(vd, "\r");
   
 	/* Note: there is a difference in how the "DIRT" command
 	** responds between the older 03.69 VDAP and the newer
@@ -498,20 +789,20 @@ unsigned *udate, *utime;
   ** So we need to handle either case by checking for an
 	** empty string and then reading another if need be.
 	*/
-  if (str_rdw(linebuff, '\r') == 0)
-		str_rdw(linebuff, '\r');
+  if (vdrdw(vd, vd->vd_line, '\r') == 0)
+		vdrdw(vd, vd->vd_line, '\r');
   
   /* result will either be the file name followed
   ** by 10 bytes, or "Command Failed".
   */
 
-  if (strcmp(linebuff, CFERROR) == 0) {
+  if (strcmp(vd->vd_line, CFERROR) == 0) {
     /* flag an error! */
     rc = -1;
   }
   else {
     /* skip over the file name (to first blank) */
-    for (c=linebuff; ((*c!=' ') && (*c!=0)); c++)
+    for (c=vd->vd_line; ((*c!=' ') && (*c!=0)); c++)
       ;
     /* read all 3 date fields */
     gethexvals(c, 10, dates);
@@ -525,15 +816,139 @@ unsigned *udate, *utime;
     *udate = fdate.i[1];
     
     /* success - gobble up the prompt */
-    str_rdw(linebuff, '\r');
+    vdrdw(vd, vd->vd_line, '\r');
   }
+#ifdef VSTATS
+  vsend(vd);
+#endif
   return rc;
 }
 
 
 /********************************************************
 **
-** vprompt
+** vdlsopen, vlsopen
+**
+** Start a streamed listing of the current directory by
+** issuing a "DIR" command. The entries are then fetched
+** one at a time with vdlsnext(), so the caller can act on
+** (or match) each name without storing the whole listing.
+**
+** Returns:
+**    0: Normal
+**    -1: Error (timed out)
+**
+********************************************************/
+int vdlsopen(vd)
+struct vdev *vd;
+{
+  vdcmd(vd, VS_DIR);
+  vdsend(vd, "dir\r");
+
+  /* first line is always blank, just read it */
+  return vdrdw(vd, vd->vd_line, '\r');
+}
+
+/********************************************************
+**
+** vdlsnext, vlsnext
+**
+** Fetch the next entry of a listing started with
+** vdlsopen() and copy its name into s. Sub-directories are
+** reported by the firmware as "NAME DIR"; the " DIR" is
+** removed from the name.
+**
+** Returns:
+**    0: s holds a file name
+**    1: s holds a directory name
+**    -1: end of the listing (prompt seen) or timeout
+**
+********************************************************/
+int vdlsnext(vd, s)
+struct vdev *vd;
+char *s;
+{
+  int ind;
+
+  if ((vdrdw(vd, vd->vd_line, '\r') == -1) ||
+      (strcmp(vd->vd_line, PROMPT) == 0)) {
+#ifdef VSTATS
+    vsend(vd);
+#endif
+    return -1;
+  }
+  if ((ind = index(vd->vd_line, " DIR")) != -1) {
+    vd->vd_line[ind] = NUL;
+    strcpy(s, vd->vd_line);
+    return 1;
+  }
+  strcpy(s, vd->vd_line);
+  return 0;
+}
+
+/********************************************************
+**
+** vdlswild, vlswild
+**
+** Add to the list nl the files in the current directory
+** that match any of the wild card patterns among
+** argv[first] .. argv[argc-1]. Switches ("-x"), arguments
+** naming a drive (containing ':') and plain names are not
+** patterns and are skipped. One streamed "DIR" listing
+** serves all the patterns, and none is issued if there
+** are no patterns. Directories never match. If the list
+** fills up no more names are added, but the listing is
+** still read up to the prompt.
+**
+** Returns:
+**    0: Normal
+**    -1: the list filled up (some files left out)
+**
+********************************************************/
+int vdlswild(vd, nl, argc, argv, first)
+struct vdev *vd;
+struct vnlist *nl;
+int argc;
+char *argv[];
+int first;
+{
+  int i, type, rc;
+  char *s;
+  static char dirname[20];
+
+  for (i=first; (i<argc) && !vdwpat(argv[i]); i++)
+    ;
+  if (i == argc)
+    return 0;
+
+  rc = 0;
+  vdlsopen(vd);
+  while ((type = vdlsnext(vd, dirname)) != -1) {
+    if ((type != 0) || (rc == -1))
+      continue;
+    for (i=first; i<argc; i++) {
+      s = argv[i];
+      if (vdwpat(s) && wcmatch(s, dirname)) {
+        rc = vnladd(nl, dirname);
+        break;
+      }
+    }
+  }
+  return rc;
+}
+
+/* vdwpat - TRUE if argument s is a wild card pattern for
+** vdlswild().
+*/
+int vdwpat(s)
+char *s;
+{
+  return (*s != '-') && (index(s, ":") == -1) && iswild(s);
+}
+
+/********************************************************
+**
+** vdprompt, vprompt
 **
 ** check for "D:\>" prompt. 
 **
@@ -542,24 +957,36 @@ unsigned *udate, *utime;
 **    -1 on error (no prompt or timeout)
 **
 ********************************************************/
-int vprompt()
+int vdprompt(vd)
+struct vdev *vd;
 {
+  int rc;
+#ifdef VSTATS
+  long t;
+
+  t = ticks();
+#endif
 #ifdef DEBUG
   printf("->vprompt\n");
 #endif
 
   /* check for normal prompt return (return if timeout) */
-  if (str_rdw(linebuff, '\r') == -1)
-    return -1;
-  else if (strcmp(linebuff, PROMPT) != 0 )
-    return -1;
+  if (vdrdw(vd, vd->vd_line, '\r') == -1)
+    rc = -1;
+  else if (strcmp(vd->vd_line, PROMPT) != 0 )
+    rc = -1;
   else
-    return 0;
+    rc = 0;
+#ifdef VSTATS
+  vstprm += ticks() - t;
+  vsend(vd);
+#endif
+  return rc;
 }
 
 /********************************************************
 **
-** vropen
+** vdropen, vropen
 **
 ** This is an interface to the Vinculum "OPR" command
 ** (Open File For Read).
@@ -571,21 +998,23 @@ int vprompt()
 **    -1 on error
 **
 ********************************************************/
-int vropen(s)
+int vdropen(vd, s)
+struct vdev *vd;
 char *s;
 {
   /* as a safety measure, close any open file */
-  vclf();
+  vdclf(vd);
+  vdcmd(vd, VS_OPN);
   
-  str_send("opr ");
-  str_send(s);
-  str_send("\r");
-  return vprompt();
+  vdsend(vd, "opr ");
+  vdsend(vd, s);
+  vdsend(vd, "\r");
+  return vdprompt(vd);
 }
 
 /********************************************************
 **
-** vwopen
+** vdwopen, vwopen
 **
 ** This is an interface to the Vinculum "OPW" command
 ** (Open File For Write).
@@ -598,85 +1027,120 @@ char *s;
 **    -1 on error
 **
 ********************************************************/
-int vwopen(s)
+int vdwopen(vd, s)
+struct vdev *vd;
 char *s;
 {
   /* as a safety measure, close any open file */
-  vclf();
+  vdclf(vd);
+  vdcmd(vd, VS_OPN);
   
-  str_send("opw ");
-  str_send(s);
-  str_send(td_string);
-  str_send("\r");
+  vdsend(vd, "opw ");
+  vdsend(vd, s);
+  vdsend(vd, td_string);
+  vdsend(vd, "\r");
   
   /* allow a little extra time if new file */
-  return vprompt();
+  return vdprompt(vd);
 }
 
 /********************************************************
 **
-** vseek
+** vdseek, vseek
 **
 ** This is an interface to the Vinculum "SEK" command
 ** (Seek).
 **
 ** This routine seeks to an absolute offset position
-** in an open file. 
+** in an open file. The offset is a long and is sent as
+** an unsigned 32-bit value, so any position in a file of
+** up to 4 GB can be reached.
 **
 ********************************************************/
-int vseek(p)
-int p;
+int vdseek(vd, p)
+struct vdev *vd;
+long p;
 {
-  static char fpos[7];
+  static char fpos[12];
   
-  str_send("sek ");
-  str_send(itoa(p, fpos));
-  str_send("\r");
-  return vprompt();
+  vdcmd(vd, VS_SEK);
+  vdsend(vd, "sek ");
+  vdsend(vd, ltodec(p, fpos));
+  vdsend(vd, "\r");
+  return vdprompt(vd);
 }
 
 /********************************************************
 **
-** vclose
+** vdclose, vclose
 **
 ** This is an interface to the Vinculum "CLF" command
 ** (Close File).
 **
 ** This closes the specified file on the USB device.
-** This should be called after a vropen() and vread()
-** sequence, or a vwopen() and vwrite() sequence of calls.
+** This should be called after a vdropen() and vdread()
+** sequence, or a vdwopen() and vdwrite() sequence of calls.
 **
 ********************************************************/
-int vclose(s)
+int vdclose(vd, s)
+struct vdev *vd;
 char *s;
 {
-  str_send("clf ");
-  str_send(s);
-  str_send("\r");
-  return vprompt();
+  vdcmd(vd, VS_CLF);
+  vdsend(vd, "clf ");
+  vdsend(vd, s);
+  vdsend(vd, "\r");
+  return vdprompt(vd);
 }
 
 /********************************************************
 **
-** vclf
+** vdclf, vclf
 **
 ** This is an interface to the Vinculum "CLF" command
 ** (Close File).
 **
 ** This closes the currently open file on the USB device.
-** This should be called after a vropen() and vread()
-** sequence, or a vwopen() and vwrite() sequence of calls.
+** This should be called after a vdropen() and vdread()
+** sequence, or a vdwopen() and vdwrite() sequence of calls.
 **
 ********************************************************/
-int vclf()
+int vdclf(vd)
+struct vdev *vd;
+{
+  vdcmd(vd, VS_CLF);
+  vdsend(vd, "clf\r");
+  return vdprompt(vd);
+}
+
+/********************************************************
+**
+** vddlf, vdlf
+**
+** This is an interface to the Vinculum "DLF" command
+** (Delete File).
+**
+** Deletes the specified file in the current directory.
+**
+** Returns:
+**    0 normal
+**    -1 on error (e.g. file not found)
+**
+********************************************************/
+int vddlf(vd, s)
+struct vdev *vd;
+char *s;
 {
-  str_send("clf\r");
-  return vprompt();
+  vdcmd(vd, VS_OTH);
+  vdsend(vd, "dlf ");
+  vdsend(vd, s);
+  vdsend(vd, "\r");
+  return vdprompt(vd);
 }
 
 /********************************************************
 **
-** vipa
+** vdipa, vipa
 **
 ** This is an interface to the Vinculum "IPA" command
 ** (Input In ASCII).
@@ -686,21 +1150,27 @@ int vclf()
 ** characters. 
 **
 ********************************************************/
-int vipa()
+int vdipa(vd)
+struct vdev *vd;
 {
-  str_send("ipa\r");
-  return vprompt();
+  int rc;
+
+  vdcmd(vd, VS_OTH);
+  vdsend(vd, "ipa\r");
+  if ((rc = vdprompt(vd)) == 0)
+    vd->vd_mode = VDM_ASC;
+  return rc;
 }
 
 /********************************************************
 **
-** vread
+** vdread, vread
 **
 ** This is an interface to the Vinculum "RDF" command
 ** (Read From File).
 **
 ** This routine should only be called after a successful
-** call to vropen(), which opens a file on the device
+** call to vdropen(), which opens a file on the device
 ** for reading.  This routine reads n bytes from the file
 ** on the USB device, storing them in the provided buffer.
 ** Once all bytes have been written it then waits for the
@@ -716,46 +1186,112 @@ int vipa()
 **    -1 on Error
 **
 ********************************************************/
-int vread(buff, n)
+int vdread(vd, buff, n)
+struct vdev *vd;
+char *buff;
+int n;
+{
+  vdrsend(vd, n);
+  return vdrget(vd, buff, n);
+}
+
+/********************************************************
+**
+** vdrsend, vdrget
+**
+** The two halves of vdread(). vdrsend() sends the RDF
+** command for n bytes; vdrget() then reads the n bytes
+** and the prompt that follows them. Between the two the
+** VNC1L is fetching the data from the drive, and the
+** program is free to talk to another device - vpip uses
+** this to keep both drives busy when copying from one
+** VDIP1 to another.
+**
+** vdrget() Returns:
+**    0 on Success
+**    -1 on Error
+**
+********************************************************/
+int vdrsend(vd, n)
+struct vdev *vd;
+int n;
+{
+  static char fsize[7];
+
+  vdcmd(vd, VS_RDF);
+  vd->vd_nin += n;
+#ifdef VSTATS
+  vsbin += n;
+#endif
+  /* send read from file (RDF) command */
+  vdsend(vd, "rdf ");
+  vdsend(vd, itoa(n, fsize));
+  vdsend(vd, "\r");
+}
+
+int vdrget(vd, buff, n)
+struct vdev *vd;
 char *buff;
 int n;
 {
   int i;
   char *nxt;
-  static char fsize[7];
+  /* the ports are copied out of vd for the byte loop */
+  static int pdat, pstat;
+#ifdef VSTATS
+  unsigned w;
+#endif
   
 #ifdef DEBUG
   printf("->vread\n");
 #endif
-  /* send read from file (RDF) command */
-  str_send("rdf ");
-  str_send(itoa(n, fsize));
-  str_send("\r");
+  pdat = vd->vd_data;
+  pstat = vd->vd_stat;
+#ifdef VSTATS
+  w = 0;
+#endif
   
-  /* immediately capture the result in the buffer */
+  /* capture the result in the buffer */
   nxt=buff;
   for (i=0; i<n ; i++) {
     /* wait for RX flag, then read the byte */
-    while ((inp(p_stat) & VRXF) == 0)
+    while ((inp(pstat) & VRXF) == 0)
+#ifdef VSTATS
+      ++w;
+    /* keep the int count from wrapping */
+    if (w & 0x4000) {
+      vsrxp += w;
+      w = 0;
+    }
+#else
       ; /* wait... */
-    *nxt++ = inp(p_data);
+#endif
+#ifdef VTRACE
+    *nxt = inp(pdat);
+    vtrec(VT_IN, *nxt++);
+#else
+    *nxt++ = inp(pdat);
+#endif
   }
+#ifdef VSTATS
+  vsrxp += w;
+#endif
 #ifdef DEBUG
     printf("%d bytes read\n", n);
 #endif
 
-  return vprompt();
+  return vdprompt(vd);
 }
 
 /********************************************************
 **
-** vwrite
+** vdwrite, vwrite
 **
 ** This is an interface to the Vinculum "WRF" command
 ** (Write To File).
 **
 ** This routine should only be called after a successful
-** call to vwopen(), which opens a file on the device
+** call to vdwopen(), which opens a file on the device
 ** for writing.  This routine writes n bytes from the
 ** provided buffer to the file on the USB device.  Once
 ** all bytes have been written it then waits for the
@@ -767,31 +1303,113 @@ int n;
 **    -1 on Error
 **
 ********************************************************/
-int vwrite(buff, n)
+int vdwrite(vd, buff, n)
+struct vdev *vd;
 char *buff;
 int n;
 {
-  int i, rc;
+  if (vdwsend(vd, buff, n) == -1)
+    return -1;
+  return vdprompt(vd);
+}
+
+/********************************************************
+**
+** vdwsend
+**
+** The first half of vdwrite(): send the WRF command and
+** the n bytes of data, but do not wait for the prompt,
+** which comes once the VNC1L has written the data to the
+** drive. vdprompt() must be called before the next command
+** to the same device; meanwhile the program can read its
+** next block or talk to another device.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error (timed out)
+**
+********************************************************/
+int vdwsend(vd, buff, n)
+struct vdev *vd;
+char *buff;
+int n;
+{
+  int i;
   static char wsize[7];
 
-  rc = 0;
+  vdcmd(vd, VS_WRF);
+  vd->vd_nout += n;
+#ifdef VSTATS
+  vsbout += n;
+#endif
   
   /* write to file (WRF) command */
-  str_send("wrf ");
-  str_send(itoa(n, wsize));
-  str_send("\r");
+  if (vdsend(vd, "wrf ") == -1)
+    return -1;
+  vdsend(vd, itoa(n, wsize));
+  vdsend(vd, "\r");
   
   /* now output the n bytes to the device */
   for (i=0; i<n; i++) {
-    out_v(*buff++);
+    vdout(vd, *buff++);
   }
+  return 0;
+}
 
-  return vprompt();
+/********************************************************
+**
+** vdmwrite
+**
+** Mirrored write: write the same n bytes to the files
+** open on two devices. Each device's prompt for the
+** previous block is only read just before it is sent the
+** next one, so one VNC1L writes to its drive while the
+** other is receiving, and both are writing while the
+** program reads its next block. Call with n = 0 at the end
+** of the file to wait for the last block on both.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error, on either device
+**
+********************************************************/
+int vdmwrite(vd1, vd2, buff, n)
+struct vdev *vd1, *vd2;
+char *buff;
+int n;
+{
+  int rc;
+
+  rc = 0;
+  if (vdmone(vd1, buff, n) == -1)
+    rc = -1;
+  if (vdmone(vd2, buff, n) == -1)
+    rc = -1;
+  return rc;
+}
+
+/* vdmone - one device's part of vdmwrite() */
+int vdmone(vd, buff, n)
+struct vdev *vd;
+char *buff;
+int n;
+{
+  int rc;
+
+  rc = 0;
+  if (vd->vd_wpend && (vdprompt(vd) == -1))
+    rc = -1;
+  vd->vd_wpend = FALSE;
+  if ((rc == 0) && (n > 0)) {
+    rc = vdwsend(vd, buff, n);
+    vd->vd_wpend = (rc == 0);
+  }
+  return rc;
 }
 
 /********************************************************
 **
-** vcd
+** vdcd, vcd
 **
 ** Change to the specified directory, relative to the
 ** current location.  Levels can be changed only one
@@ -802,48 +1420,54 @@ int n;
 **  -1  = fail
 **
 ********************************************************/
-int vcd(dir)
+int vdcd(vd, dir)
+struct vdev *vd;
 char *dir;
 {
   int rc;
   
   rc = 0;
+  vdcmd(vd, VS_OTH);
   
-  str_send("cd ");
-  str_send(dir);
-  str_send("\r");
+  vdsend(vd, "cd ");
+  vdsend(vd, dir);
+  vdsend(vd, "\r");
   
   /* The result will either be the Prompt or an error
   ** message. If the latter then return error.
   */
-  str_rdw(linebuff, '\r');
+  vdrdw(vd, vd->vd_line, '\r');
 
-  if (strcmp(linebuff, PROMPT) != 0) {
+  if (strcmp(vd->vd_line, PROMPT) != 0) {
     /* command failed */
     rc = -1;
   }
+#ifdef VSTATS
+  vsend(vd);
+#endif
   
   return rc;
 }
 
 /********************************************************
 **
-** vcdroot
+** vdcdroot, vcdroot
 **
 ** Change the directory to be root ('/').  This is done
 ** by issuing successive "CD .." commands until the command
 ** fails.
 **
 ********************************************************/
-int vcdroot()
+int vdcdroot(vd)
+struct vdev *vd;
 {
-  while(vcdup() == 0)
+  while(vdcdup(vd) == 0)
     ;
 }
 
 /********************************************************
 **
-** vcdup
+** vdcdup, vcdup
 **
 ** Change the directory up one level by issuing 
 ** the "CD .." command
@@ -853,30 +1477,35 @@ int vcdroot()
 **    -1 if fail (i.e. at "root" level)
 **
 ********************************************************/
-int vcdup()
+int vdcdup(vd)
+struct vdev *vd;
 {
   int rc;
   
   rc = 0;
+  vdcmd(vd, VS_OTH);
   
-  str_send("cd ..\r");
+  vdsend(vd, "cd ..\r");
   
   /* The result will either be the Prompt or
   ** "Command Failed". If the latter then return error.
   */
-  str_rdw(linebuff, '\r');
+  vdrdw(vd, vd->vd_line, '\r');
 
-  if (strcmp(linebuff, CFERROR) == 0) {
+  if (strcmp(vd->vd_line, CFERROR) == 0) {
     /* flag an error! */
     rc = -1;
   }
+#ifdef VSTATS
+  vsend(vd);
+#endif
   
   return rc;
 }
 
 /********************************************************
 **
-** vmkd
+** vdmkd, vmkd
 **
 ** Create the specified sub-directory in the current
 ** directory. Sets the time/date stamp based on current
@@ -887,7 +1516,8 @@ int vcdup()
 **  -1  = fail
 **
 ********************************************************/
-int vmkd(dir)
+int vdmkd(vd, dir)
+struct vdev *vd;
 char *dir;
 {
   int rc;
@@ -896,21 +1526,499 @@ char *dir;
   
   /* first set up the file date for MKD command */
 	settd(FALSE);
+  vdcmd(vd, VS_OTH);
 	
-  str_send("mkd ");
-  str_send(dir);
-  str_send(td_string);
-  str_send("\r");
+  vdsend(vd, "mkd ");
+  vdsend(vd, dir);
+  vdsend(vd, td_string);
+  vdsend(vd, "\r");
   
   /* The result will either be the Prompt or an error
   ** message. If the latter then return error.
   */
-  str_rdw(linebuff, '\r');
+  vdrdw(vd, vd->vd_line, '\r');
 
-  if (strcmp(linebuff, PROMPT) != 0) {
-    printf("MKD %s: %s\n", dir, linebuff);
+  if (strcmp(vd->vd_line, PROMPT) != 0) {
+    printf("MKD %s: %s\n", dir, vd->vd_line);
     rc = -1;
   }
+#ifdef VSTATS
+  vsend(vd);
+#endif
   
   return rc;
 }
+
+/********************************************************
+**
+** vddef
+**
+** The default device, used by the original global API
+** below: the ports in p_data and p_stat and the line
+** buffer linebuff. These are copied in on every call, so
+** a program may still set p_data and p_stat at any time
+** and read replies from linebuff as before.
+**
+********************************************************/
+struct vdev *vddef()
+{
+  vdflt.vd_data = p_data;
+  vdflt.vd_stat = p_stat;
+  vdflt.vd_line = linebuff;
+  return &vdflt;
+}
+
+/********************************************************
+**
+** vport
+**
+** Point the default device, and so the global API, at the
+** VDIP1 at port by setting p_data and p_stat; code written
+** for the global API (vcrcf() for one) can then be used on
+** a second device. Returns the data port it was using.
+**
+********************************************************/
+int vport(port)
+int port;
+{
+  int old;
+
+  old = p_data;
+  p_data = port;
+  p_stat = port + 1;
+  return old;
+}
+
+/********************************************************
+**
+** Global API
+**
+** Each of these is the vd function of the same purpose
+** applied to the default device; see above for details.
+**
+********************************************************/
+int str_send(s)
+char *s;
+{
+  return vdsend(vddef(), s);
+}
+
+int str_rdw(s, tchar)
+char *s;
+char tchar;
+{
+  return vdrdw(vddef(), s, tchar);
+}
+
+int in_v()
+{
+  return vdin(vddef());
+}
+
+int out_v(c)
+char c;
+{
+  return vdout(vddef(), c);
+}
+
+int in_vwait(t)
+int t;
+{
+  return vdinw(vddef(), t);
+}
+
+int out_vwait(c, t)
+char c;
+int t;
+{
+  return vdoutw(vddef(), c, t);
+}
+
+int vfind_disk()
+{
+  return vdfind(vddef());
+}
+
+int vpurge()
+{
+  return vdpurge(vddef());
+}
+
+int vhandshake()
+{
+  return vdhand(vddef());
+}
+
+int vinit()
+{
+  return vdinit(vddef());
+}
+
+int vsync()
+{
+  return vdsync(vddef());
+}
+
+int vdirf(s, len)
+char *s;
+long *len;
+{
+  return vddirf(vddef(), s, len);
+}
+
+long vapoff(s, chan)
+char *s;
+int chan;
+{
+  return vdapoff(vddef(), s, chan);
+}
+
+int vdird(s, udate, utime)
+char *s;
+unsigned *udate, *utime;
+{
+  return vddird(vddef(), s, udate, utime);
+}
+
+int vlsopen()
+{
+  return vdlsopen(vddef());
+}
+
+int vlsnext(s)
+char *s;
+{
+  return vdlsnext(vddef(), s);
+}
+
+int vlswild(nl, argc, argv, first)
+struct vnlist *nl;
+int argc;
+char *argv[];
+int first;
+{
+  return vdlswild(vddef(), nl, argc, argv, first);
+}
+
+int vprompt()
+{
+  return vdprompt(vddef());
+}
+
+int vropen(s)
+char *s;
+{
+  return vdropen(vddef(), s);
+}
+
+int vwopen(s)
+char *s;
+{
+  return vdwopen(vddef(), s);
+}
+
+int vseek(p)
+long p;
+{
+  return vdseek(vddef(), p);
+}
+
+int vclose(s)
+char *s;
+{
+  return vdclose(vddef(), s);
+}
+
+int vclf()
+{
+  return vdclf(vddef());
+}
+
+int vdlf(s)
+char *s;
+{
+  return vddlf(vddef(), s);
+}
+
+int vipa()
+{
+  return vdipa(vddef());
+}
+
+int vread(buff, n)
+char *buff;
+int n;
+{
+  return vdread(vddef(), buff, n);
+}
+
+int vwrite(buff, n)
+char *buff;
+int n;
+{
+  return vdwrite(vddef(), buff, n);
+}
+
+int vcd(dir)
+char *dir;
+{
+  return vdcd(vddef(), dir);
+}
+
+int vcdroot()
+{
+  return vdcdroot(vddef());
+}
+
+int vcdup()
+{
+  return vdcdup(vddef());
+}
+
+int vmkd(dir)
+char *dir;
+{
+  return vdmkd(vddef(), dir);
+}
+
+/********************************************************
+**
+** vscmd, vsend
+**
+** Instrumentation (compiled in with -qVSTATS=1): vscmd()
+** counts a command of class c on device vd and notes the
+** time it was issued; vsend() charges the time since then
+** to that class once the device has completed it.
+**
+********************************************************/
+#ifdef VSTATS
+int vscmd(vd, c)
+struct vdev *vd;
+int c;
+{
+  vd->vd_scls = c;
+  ++vsncmd[c];
+  vd->vd_sts = ticks();
+#ifdef VTRACE
+  vtrec(VT_CMD, c);
+#endif
+}
+
+int vsend(vd)
+struct vdev *vd;
+{
+  if (vd->vd_scls != -1)
+    vstcmd[vd->vd_scls] += ticks() - vd->vd_sts;
+  vd->vd_scls = -1;
+#ifdef VTRACE
+  vtrec(VT_END, 0);
+#endif
+}
+
+/* vsms - format ticks t as milliseconds in s */
+char *vsms(t, s)
+long t;
+char *s;
+{
+  return ltodec(t * 1000L / tickhz(), s);
+}
+
+/* vsper - format a / b to one decimal place in s */
+char *vsper(a, b, s)
+long a, b;
+char *s;
+{
+  if (b == 0L)
+    b = 1L;
+  return ltotenth(a * 10L / b, s);
+}
+#endif
+
+/********************************************************
+**
+** vstats
+**
+** Print a summary of the statistics gathered since
+** vinit(): commands issued and time taken by class, data
+** bytes moved, status polls per data byte (for whichever
+** way data moved), polls spent waiting for replies,
+** timeouts and the overall throughput. The library must be compiled with
+** -qVSTATS=1 for this to be available.
+**
+********************************************************/
+int vstats()
+{
+#ifdef VSTATS
+  int i;
+  long t, bytes;
+  static char s1[15], s2[15];
+
+  t = ticks() - vst0;
+  bytes = vsbin + vsbout;
+  printf("\nUSB statistics\n");
+  printf("  Command       Count          ms\n");
+  for (i=0; i<VS_N; i++) {
+    if (vsncmd[i] == 0L)
+      continue;
+    strncpy(s1, VSNAMES + i*7, 7);
+    s1[7] = NUL;
+    printf("  %s  %10s  %10s\n", s1, ltodec(vsncmd[i], s2),
+      vsms(vstcmd[i], linebuff));
+  }
+  printf("  Bytes read %s, written %s\n", ltodec(vsbin, s1),
+    ltodec(vsbout, s2));
+  /* per byte figures only for data actually moved */
+  if ((vsbin > 0L) || (vsbout > 0L)) {
+    printf("  Status polls per byte:");
+    if (vsbin > 0L)
+      printf(" RXF %s", vsper(vsrxp, vsbin, s1));
+    if (vsbout > 0L)
+      printf(" TXE %s", vsper(vstxp, vsbout, s1));
+    printf("\n");
+  }
+  printf("  Reply waits %s polls, prompt waits %s ms\n", ltodec(vsrwp, s1),
+    vsms(vstprm, s2));
+  printf("  %d timeout%s\n", vstmo, (vstmo == 1) ? "" : "s");
+  printf("  Elapsed %s ms", vsms(t, s1));
+  /* rate from the time in tenths of a second */
+  if ((t = t * 10L / tickhz()) > 0L)
+    printf(", %s bytes/second", ltodec(bytes * 10L / t, s2));
+  printf("\n");
+#ifdef VTRACE
+  if (vtrdump(VTRFILE) == -1)
+    printf("  Unable to write trace to %s\n", VTRFILE);
+  else
+    printf("  Trace written to %s\n", VTRFILE);
+#endif
+#else
+  printf("No statistics - the library was built without VSTATS\n");
+#endif
+}
+
+/********************************************************
+**
+** vtrec, vtrin, vtrclk
+**
+** Tracing (compiled in with -qVTRACE=1): vtrec() adds an
+** event of type t with data byte d to the ring, stamped
+** with the raw clock from vtrclk() - the 2ms tick counter,
+** or the seconds clock on CP/M 3 and MP/M. vtrin() records
+** a byte received and returns it.
+**
+********************************************************/
+#ifdef VTRACE
+int vtrec(t, d)
+char t, d;
+{
+  char *p;
+  unsigned c;
+
+  if (vtroff)
+    return;
+  c = vtrclk();
+  p = vtrbuf + vtrpos;
+  *p++ = t;
+  *p++ = d;
+  *p++ = c & 0xFF;
+  *p = c >> 8;
+  if ((vtrpos += 4) >= VTRSIZE) {
+    vtrpos = 0;
+    vtrwrp = TRUE;
+  }
+}
+
+int vtrin(c)
+int c;
+{
+  vtrec(VT_IN, c);
+  return c;
+}
+
+int vtrclk()
+{
+  static unsigned *Ticptr = TICCNT;
+
+  if (vtrhz == 1)
+    return btod(*secclk());
+  return *Ticptr;
+}
+
+/* vtrput - write n bytes of the dump to the USB file if usb
+** is TRUE, otherwise to local channel chan.
+*/
+int vtrput(usb, chan, buf, n)
+int usb, chan;
+char *buf;
+int n;
+{
+  if (n <= 0)
+    return 0;
+  if (usb)
+    return vwrite(buf, n);
+  return (write(chan, buf, n) == -1) ? -1 : 0;
+}
+#endif
+
+/********************************************************
+**
+** vtrdump
+**
+** Write the trace to a file: a USB file if name starts
+** "USB:", otherwise a local file. The file holds a 16 byte
+** header - "VTRACE", ticks per second and the number of
+** events, each two bytes LSB first - then the events,
+** oldest first. A local file is padded out to a whole
+** record, so the event count is needed to read it.
+**
+** Returns:
+**    0 on Success
+**    -1 on Error, or if the library was built without
+**       VTRACE
+**
+********************************************************/
+int vtrdump(name)
+char *name;
+{
+#ifdef VTRACE
+  int usb, chan, rc, n;
+  static char hdr[VTRHDR];
+
+  /* the dump itself is not traced */
+  vtroff = TRUE;
+  n = (vtrwrp ? VTRSIZE : vtrpos) / 4;
+  strcpy(hdr, "VTRACE");
+  hdr[6] = vtrhz & 0xFF;
+  hdr[7] = vtrhz >> 8;
+  hdr[8] = n & 0xFF;
+  hdr[9] = n >> 8;
+  for (n=10; n<VTRHDR; n++)
+    hdr[n] = 0;
+
+  chan = 0;
+  if (usb = (index(name, "USB:") == 0)) {
+    /* OPW appends, so start from an empty file */
+    vdlf(name+4);
+    rc = vwopen(name+4);
+  }
+  else
+    rc = ((chan = fopen(name, "wb")) == 0) ? -1 : 0;
+  if (rc == 0) {
+    rc = vtrput(usb, chan, hdr, VTRHDR);
+    /* oldest events are from vtrpos on if the ring wrapped */
+    if ((rc == 0) && vtrwrp)
+      rc = vtrput(usb, chan, vtrbuf + vtrpos, VTRSIZE - vtrpos);
+    if (rc == 0)
+      rc = vtrput(usb, chan, vtrbuf, vtrpos);
+    if (usb) {
+      if (vclose(name+4) == -1)
+        rc = -1;
+    }
+    else
+      fclose(chan);
+  }
+  vtroff = FALSE;
+  return rc;
+#else
+  return -1;
+#endif
+}
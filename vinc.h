@@ -10,15 +10,38 @@
 **	4.3 (Beta) 4 Sep 2025
 **		changed default port to 261-1
 **
+**	18 October 2026
+**		added struct vdev for the vd functions
+**
 ********************************************************/
 #ifndef EXTERN
 #define EXTERN extern
 #endif
 
+/* one VDIP1 device, set up by vdopen() */
+struct vdev {
+        int vd_data;            /* data port */
+        int vd_stat;            /* status port */
+        char *vd_line;          /* 128 byte line buffer */
+        int vd_mode;            /* VDM_ value */
+        long vd_ncmd;           /* commands issued */
+        long vd_nin;            /* data bytes read (RDF) */
+        long vd_nout;           /* data bytes written (WRF) */
+        int vd_ntmo;            /* timeouts */
+        int vd_wpend;           /* WRF sent, prompt not yet read */
+        int vd_scls;            /* VSTATS class of command in progress */
+        long vd_sts;            /* VSTATS tick it was issued */
+};
+
+/* vd_mode */
+#define VDM_NONE 0              /* not yet initialized */
+#define VDM_ASC  1              /* ASCII mode (IPA) set */
+
 EXTERN char td_string[15];      /* time/date hex value */
 EXTERN char linebuff[128];      /* I/O line buffer */
 EXTERN int p_data;
 EXTERN int p_stat;
+EXTERN struct vdev vdflt;       /* device behind the global API */
 
 /* FTDI VDIP bits */
 #define VTXE    004             /* TXE# when hi ok to write */
@@ -59,13 +82,18 @@ int vhandshake();
 int vinit();
 int vsync();
 int vdirf();
+long vapoff();
 int vdird();
+int vlsopen();
+int vlsnext();
+int vlswild();
 int vprompt();
 int vropen();
 int vwopen();
 int vseek();
 int vclose();
 int vclf();
+int vdlf();
 int vipa();
 int vread();
 int vwrite();
@@ -73,3 +101,48 @@ int vcd();
 int vcdroot();
 int vcdup();
 int vmkd();
+int vstats();
+int vtrdump();
+
+/* the same for a given device */
+int vdopen();
+int vdsetup();
+struct vdev *vddef();
+int vport();
+int vdcmd();
+int vdsend();
+int vdrdw();
+int vdin();
+int vdout();
+int vdinw();
+int vdoutw();
+int vdfind();
+int vdpurge();
+int vdhand();
+int vdinit();
+int vdsync();
+int vddirf();
+long vdapoff();
+int vddird();
+int vdlsopen();
+int vdlsnext();
+int vdlswild();
+int vdprompt();
+int vdropen();
+int vdwopen();
+int vdseek();
+int vdclose();
+int vdclf();
+int vddlf();
+int vdipa();
+int vdread();
+int vdrsend();
+int vdrget();
+int vdwrite();
+int vdwsend();
+int vdmwrite();
+int vdmone();
+int vdcd();
+int vdcdroot();
+int vdcdup();
+int vdmkd();
@@ -4,7 +4,7 @@
 ** This program lets the user create a new sub-directory
 ** under the current directory on the USB device.
 **
-** Usage:  vmd directory
+** Usage:  vmd directory {-s} {-pxxx}
 **
 ** This code is OS-agnostic - should compile and run on
 ** HDOS and all versions of CP/M.
@@ -12,7 +12,7 @@
 ** Compiled with Software Toolworks C/80 V. 3.1 with support for
 ** floats and longs.  Typical link statement:
 **
-** L80 vmd,vinc,vutil,pio,fprintf,scanf,flibrary/s,stdlib/s,clibrary/s,vmd/n/e
+** L80 vmd,vinc,vutil,pio,fprintf,seek,scanf,flibrary/s,stdlib/s,clibrary/s,vmd/n/e
 **
 ** Our convention is to save all files with CP/M style
 ** line endings (CR-LF). The HDOS version of C/80 is picky
@@ -31,6 +31,9 @@
 #include "vutil.h"
 #include "vinc.h"
 
+/* show USB statistics at exit (-s) */
+int f_stats;
+
 /* dosw - process any switches on the command line.
 ** Switches are preceded by "-".  If a numeric value
 ** is given there should be no space, for example:
@@ -54,6 +57,9 @@ char *argv[];
     if (*s++ == '-') {
       /* have a switch! */
       switch (*s) {
+      case 'S':
+        f_stats = TRUE;
+        break;
       case 'P':
         ++s;
         p_data = aotoi(s);
@@ -103,6 +109,7 @@ char *argv[];
     printf("No flash drive found!\n");
   else if ((argc < 2) || (index(argv[1], "\\") != -1)) {
     printf("Usage: vmd <directory> <-pxxx>\n");
+    printf("\t-s to show USB statistics at exit\n");
     printf("\txxx is USB optional port in octal (default is %o)\n", VDATA);
   }
   else {
@@ -111,4 +118,6 @@ char *argv[];
 		else
 			printf("Error creating directory %s\n", argv[1]);
   }
+  if (f_stats)
+    vstats();
 }
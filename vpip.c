@@ -40,8 +40,9 @@
 ** for CP/M or SY0: SY1:... for HDOS) denote system drives.
 **
 ** Files may only be copied between the USB device and the
-** system devices. USB-to-USB, and system-to-system copies
-** are not supported - use PIP for those.
+** system devices, or between the USB device and the drive
+** on a second VDIP-1 (US2:, see below). System-to-system
+** copies are not supported - use PIP for those.
 **
 ** This code is designed for use with the Software Toolworks C/80
 ** v. 3.1 compiler with the optional support for
@@ -55,7 +56,7 @@
 **
 ** Typical link command:
 **
-** L80 vpip,vinc,vutil,pio,fprintf,scanf,flibrary/s,stdlib/s,clibrary/s,vpip/n/e
+** L80 vpip,vcrc,crc,vcache,vinc,vutil,pio,fprintf,scanf,seek,flibrary/s,stdlib/s,clibrary/s,vpip/n/e
 **
 ** This code uses ifndef to insert a call to CtlCk(), which 
 ** is necessary in CP/M to check for CTRL-C interrupts. This
@@ -82,6 +83,51 @@
 ** 12 April 2025 - simplified version and port reporting to single line.
 ** added "verbose" switch (-v) - default is "quiet"
 **
+** 18 October 2026 - copies are checkpointed in a journal file
+** (VPIP.JNL) on the current drive. "-r" resumes an interrupted
+** batch from the last verified offset.
+**
+** 18 October 2026 - a unique destination file name with more
+** than one matching source concatenates all of them into it,
+** e.g. USB:ALL.TXT=A:*.ASM.
+**
+** 18 October 2026 - "-b" treats the USB file as a CP/M .LBR
+** library: USB:SRC.LBR=A:*.ASM -B packs the files into one
+** library, A:*.ASM=USB:SRC.LBR -B extracts matching members
+** and USB:SRC.LBR -B -L lists them. Libraries are read
+** through the vcache block cache.
+**
+** 18 October 2026 - "-k" verifies each file copied: a CRC is
+** kept of the bytes sent or received and the copy is read back
+** once (from the USB drive for puts, from the local disk for
+** gets) and checked against it. -V was taken by verbose mode.
+** Resumed, concatenated and library copies are not verified.
+**
+** 18 October 2026 - "-a" appends to existing USB files: only
+** the part of each local file beyond the length of its USB copy
+** is sent, e.g. USB:=A:*.LOG -A. A local file shorter than its
+** USB copy is copied again in full.
+**
+** 18 October 2026 - "-s" shows USB transfer statistics at
+** exit (the library must be built with VSTATS, see vinc.c).
+**
+** 18 October 2026 - "-mxxx" mirrors puts to the USB drive on
+** a second VDIP-1 at octal port xxx, e.g. USB:=A:*.* -M271.
+** Each block read is written to both drives, one VNC1L
+** receiving while the other writes, so both copies take
+** little longer than one. Resume and append start from the
+** shorter of the two USB files and -k checks both copies.
+** Concatenated and library copies are not mirrored.
+**
+** 18 October 2026 - the pseudo-drive "US2:" is the USB drive
+** on a second VDIP-1, at octal port xxx given by "-uxxx"
+** (default 271), e.g. US2:=USB:*.DOC copies straight from
+** one drive to the other with no local disk involved. Each
+** block is read into RAM and written out while the source
+** VNC1L fetches the next, so both are kept busy. The copy
+** keeps the source file's date. Concatenated and library
+** copies between the drives are not supported.
+**
 ********************************************************/
 #include "fprintf.h"
 
@@ -89,10 +135,16 @@
 #define EXTERN
 #include "vutil.h"
 #include "vinc.h"
+#include "vcrc.h"
+#include "vcache.h"
 
 #define SPACE ' '
 #define NULSTR  ""
+#ifdef HOST
+#define DMA   hostdma /* see host/c80.c */
+#else
 #define DMA   0x80    /* CP/M DMA area */
+#endif
 
 /* default devices if none specified */
 #define USBDFLT "USB"
@@ -103,10 +155,18 @@
 #define USERD 2     /* user io device */
 #define USBD  3     /* USB device */
 #define UNKD  4     /* unknown format */
+#define U2D   5     /* USB device on second VDIP-1 */
+
+#define U2PORT  0271    /* default port of US2: (-u) */
+#define UUBUFF  1024    /* block size for USB to USB copies */
 
 #define MAXD  400     /* maximum number of directory entries */
 #define DIRBUFF 512     /* buffer space for directory */
 
+/* checkpoint journal - written to the current drive */
+#define JFILE   "VPIP.JNL"
+#define JBLKS   32      /* blocks copied between checkpoints */
+
 /*********************************************
 **
 **  Key Data Structures
@@ -186,8 +246,30 @@ struct finfo {
   unsigned mdate;
   unsigned mtime;
   char tag;
+  unsigned lsec;    /* start sector of an LBR member */
 };
 
+/* CP/M .LBR library directory entry. The library starts
+** with a directory of these, entry 0 describing the
+** directory itself.  Members are stored as whole 128-byte
+** sectors; index and length are counted in sectors and
+** lpad gives the unused bytes in a member's last sector.
+*/
+struct lbrent {
+  char lstat;       /* 0 = active, 0xFE deleted, 0xFF unused */
+  char lname[8];
+  char lext[3];
+  unsigned lindex;
+  unsigned llen;
+  unsigned lcrc;
+  char ldates[8];
+  char lpad;
+  char lfill[5];
+};
+
+#define LBRSEC  128     /* LBR sector size */
+#define LBRFREE 0xFF    /* unused directory entry */
+
 /*********************************************
 **
 **  Global Static Storage
@@ -219,9 +301,44 @@ char buffer[DIRBUFF];
 #define BUFFSIZE  256
 char rwbuffer[BUFFSIZE];
 
+/* second buffer for look-ahead and for accumulating
+** output when concatenating.
+*/
+char rwbuff2[BUFFSIZE];
+
+#define RECSIZE 128     /* CP/M record size */
+#define CPMEOF  0x1A    /* CP/M text end-of-file (^Z) */
+
 /* global switch settings */
 int f_list;   /* to list directory (no file copy) */
 int verbose;  /* if FALSE (default) don't print extra info */
+int f_resume; /* resume batch recorded in the journal */
+int f_lbr;    /* USB file is an .LBR library */
+int f_verify; /* verify each copy */
+int f_append; /* put only what was added since the last copy */
+int f_mirror; /* mirror puts to a second VDIP-1 */
+
+/* the mirror VDIP-1 (-m). mirror is TRUE while a command
+** is writing to it.
+*/
+int mport;
+int mirror;
+struct vdev mirdev;
+char mirline[128];
+
+/* the second VDIP-1, for US2: */
+int uport;
+struct vdev u2dev;
+char u2line[128];
+
+/* journal state: the command being run, the file in
+** progress and the last offset known to be good.
+*/
+char jcmd[80];
+char jsrc[15];
+long joffset;
+
+char *lbrdir();
 
 
 #ifdef HDOS
@@ -675,14 +792,14 @@ int vdir2()
     dirstr(i, dirtemp);
     
     /* look up the file size and date modified */
-    if (direntries[i]->isdir) {
-      direntries[i]->size  = 0L;
-      direntries[i]->mdate = 0;
-      direntries[i]->mtime = 0;
+    if (direntry[i]->isdir) {
+      direntry[i]->size  = 0L;
+      direntry[i]->mdate = 0;
+      direntry[i]->mtime = 0;
     }
     else {
-      vdirf(dirtemp, &direntries[i]->size);
-      vdird(dirtemp, &direntries[i]->mdate, &direntries[i]->mtime);
+      vdirf(dirtemp, &direntry[i]->size);
+      vdird(dirtemp, &direntry[i]->mdate, &direntry[i]->mtime);
     }
 #ifndef HDOS
     /* check for ^C */
@@ -691,68 +808,213 @@ int vdir2()
   }
 }
 
+/* vpver - if verifying, check the copy just made
+** against the CRC kept while copying (see crcver()).
+** port is that of the VDIP-1 holding the copy, or 0 if it
+** is on the local disk. Copies resumed part way through
+** can't be checked this way, so a bad copy is journalled
+** at offset 0: -r then makes it again from the start
+** rather than keeping the bad part. Returns -1 if the copy
+** is bad, else 0.
+*/
+int vpver(port, name, len, offset)
+int port;
+char *name;
+long len, offset;
+{
+  if (!f_verify)
+    return 0;
+  if (offset > 0L) {
+    printf("  (not verified)");
+    return 0;
+  }
+  if (((port ? crcpver(port, name, len) : crcver(FALSE, name, len)) == -1) ||
+      (port && mirror && (crcpver(mport, name, len) == -1))) {
+    printf("  ** VERIFY FAILED **");
+    jwrite(TRUE, srcfname, 0L);
+    return -1;
+  }
+  printf("  verified");
+  return 0;
+}
+
+/* mirinit - set up the mirror VDIP-1 (-m)
+**
+**  Returns:   -1 on error
+*/
+int mirinit()
+{
+  if (vdsetup(&mirdev, mport, mirline) == -1)
+    return -1;
+  if (verbose)
+    printf("Mirroring to port: [%o]\n", mport);
+  return 0;
+}
+
+/* u2init - set up the second VDIP-1 for US2:
+**
+**  Returns:   -1 on error
+*/
+int u2init()
+{
+  if (uport == p_data) {
+    printf("US2: must be on a different port from USB: [%o]\n", p_data);
+    return -1;
+  }
+  if (vdsetup(&u2dev, uport, u2line) == -1)
+    return -1;
+  if (verbose)
+    printf("US2: on port: [%o]\n", uport);
+  return 0;
+}
+
 /* vcput - put a file from local source to USB destination
 **  (derived from code in VPUT)
 **
 **  Source: local file
 **  Destination: USB (VDIP)
 **
+**  If offset is non-zero the copy resumes at that offset
+**  in both files (see jread()). Otherwise with -a it is
+**  appended to the USB copy (see vdapoff()).
+**
 **  Returns:   -1 on error
+**             1 if the source file can't be opened
 */
-int vcput(source, dest)
+int vcput(source, dest, offset)
 char *source, *dest;
+long offset;
 {
-  int nbytes, channel, done, rc;
-  long filesize;
+  int nbytes, nblk, channel, done, rc, fresh, mopen;
+  long filesize, ulen, mlen;
   char fsize[15];
   
   rc = 0;
   
   if((channel = fopen(source, "rb")) == 0) {
     printf("Unable to open source file %s\n", source);
-    rc = -1;
+    rc = 1;
   }
   else {
+    /* append after what the shorter USB copy holds */
+    fresh = FALSE;
+    if (f_append && (offset == 0L)) {
+      offset = vapoff(dest, channel);
+      if (mirror && (offset > 0L) &&
+          ((mlen = vdapoff(&mirdev, dest, channel)) < offset))
+        offset = mlen;
+      fresh = (offset == 0L);
+    }
+    /* a resumed copy can only continue from data that
+    ** actually made it to the USB file.
+    */
+    else if (offset > 0L) {
+      if (vdirf(dest, &ulen) == -1)
+        ulen = 0L;
+      if (mirror) {
+        if (vddirf(&mirdev, dest, &mlen) == -1)
+          mlen = 0L;
+        if (mlen < ulen)
+          ulen = mlen;
+      }
+      if (ulen < offset)
+        offset = ulen - (ulen % BUFFSIZE);
+    }
+    /* a local file that now ends before the offset is not
+    ** the one the USB copy was made from: start over and
+    ** replace the old copies. Otherwise it is left there.
+    */
+    if ((offset > 0L) && (lseekl(channel, offset) == -1)) {
+      offset = 0L;
+      fresh = TRUE;
+    }
+    if (fresh) {
+      vdlf(dest);
+      if (mirror)
+        vddlf(&mirdev, dest);
+    }
+
     /* first set up the file date for vwopen(), display
     ** it on console the first time around
     */
     settd(TRUE);
     
     /* now open destination file on USB: and do the copy */
+    filesize = offset;
+    mopen = FALSE;
     if (vwopen(dest) == -1) {
       printf("Unable to open destination file %s\n", dest);
       rc = -1;
-      fclose(channel);
+    }
+    else if (mirror && (vdwopen(&mirdev, dest) == -1)) {
+      printf("Unable to open mirror file %s\n", dest);
+      rc = -1;
     }
     else {
-      /* start writing at beginning of file */
-      vseek(0);
-      filesize = 0L;
+      mopen = mirror;
+      /* start writing at beginning of file, or at the
+      ** checkpoint if resuming.
+      */
+      vseek(offset);
+      if (mirror)
+        vdseek(&mirdev, offset);
       printf("%-16s --> ", source);
+      if (offset > 0L)
+        printf(f_append ? "(appended) " : "(resumed) ");
     
+      if (f_verify)
+        crcbeg();
       done = FALSE;
+      nblk = 0;
       while (!done) {
         nbytes = read(channel, rwbuffer, BUFFSIZE);
-        filesize += nbytes;
         if (nbytes == 0)
           done = TRUE;
-        else if (vwrite(rwbuffer, nbytes) == -1) {
+        else if (mirror ? (vdmwrite(vddef(), &mirdev, rwbuffer, nbytes) == -1) :
+                 (vwrite(rwbuffer, nbytes) == -1)) {
           printf("\nError writing to VDIP device\n");
           rc = -1;
           done = TRUE;
         }
+        else {
+          if (f_verify)
+            crcupd(rwbuffer, nbytes);
+          filesize += nbytes;
+          /* block is on the stick - checkpoint now and then.
+          ** a mirrored block may still be being written.
+          */
+          if (++nblk == JBLKS) {
+            jwrite(TRUE, srcfname, mirror ? filesize - nbytes : filesize);
+            nblk = 0;
+          }
+        }
+      }
+      /* wait for the last block on both drives */
+      if (mirror && (vdmwrite(vddef(), &mirdev, rwbuffer, 0) == -1) &&
+          (rc == 0)) {
+        printf("\nError writing to VDIP device\n");
+        rc = -1;
       }
     }
     commafmt(filesize, fsize, 15);
 
     /* report results */
-    printf("USB:%-12s  %s bytes\n", dest, fsize);
+    printf("USB:%-12s  %s bytes", dest, fsize);
 
     /* close input file */
     fclose(channel);
       
     /* important - close file on VDIP */
     vclose(dest);
+    if (mopen) {
+      vdclose(&mirdev, dest);
+      printf(" (mirrored)");
+    }
+
+    /* read the copy back once and check it */
+    if (rc == 0)
+      rc = vpver(p_data, dest, filesize, offset);
+    printf("\n");
   }
   
   return rc;
@@ -765,43 +1027,75 @@ char *source, *dest;
 **  Destination:  local file
 **
 **  Returns:   -1 on error
+**             1 if the source file can't be opened
 */
-int vcget(source, dest)
+int vcget(source, dest, offset)
 char *source, *dest;
+long offset;
 {
-  int nblocks, nbytes, i, channel, rc, done;
-  long filesize;
+  int nbytes, j, channel, rc, done;
+  long filesize, nblocks, i;
   char fsize[15];
+  static char blk[12];
   
   rc = 0;
+  channel = 0;
   
   if (vdirf(source, &filesize) == -1) {
     printf("Unable to open file %s\n", source);
-    rc = -1;
+    rc = 1;
   }
   else {
     commafmt(filesize, fsize, 15);
     printf("USB:%-12s  %s bytes --> ", source, fsize);
   
-    /* NOTE: assumes file size < 8 meg */
-    nblocks = filesize/BUFFSIZE;
-    nbytes = filesize % BUFFSIZE;
+    /* a resumed copy reopens the partial local file
+    ** for update; if that fails, or it is shorter than
+    ** the checkpoint, start over.
+    */
+    if (offset > filesize)
+      offset = 0L;
+    if (offset > 0L) {
+      if ((channel = fopen(dest, "u")) == 0)
+        offset = 0L;
+      else if (lseekl(channel, offset) == -1) {
+        fclose(channel);
+        channel = 0;
+        offset = 0L;
+      }
+      else
+        printf("(resumed) ");
+    }
+
+    /* block count and remainder, taking the size as
+    ** unsigned so files up to 4 GB stream through
+    */
+    nblocks = (((filesize - offset) >> 1) & 0x7FFFFFFFL) / (BUFFSIZE / 2);
+    nbytes = (int) ((filesize - offset) & (BUFFSIZE - 1));
     
     /* open source file on flash device for read */
     if (vropen(source) == -1) {
       printf("Unable to open source file %s\n", source);
-      rc = -1;
+      rc = 1;
+      if (channel != 0)
+        fclose(channel);
     }
-    else if ((channel = fopen(dest, "wb")) == 0) {
+    else if ((channel == 0) && ((channel = fopen(dest, "wb")) == 0)) {
       printf("\nError opening destination file %s\n", dest);
       rc = -1;
     }
     else {
+      /* position the USB file at the checkpoint */
+      if (offset > 0L)
+        vseek(offset);
+      if (f_verify)
+        crcbeg();
+
       /* source and destination files open - begin copying */
-      for (done=FALSE, i=1; ((i<=nblocks) && (!done)); i++) {
+      for (done=FALSE, i=1L; ((i<=nblocks) && (!done)); i++) {
         /* read a block from input file */
         if (vread(rwbuffer, BUFFSIZE) == -1) {
-          printf("\nError reading block %d\n", i);
+          printf("\nError reading block %s\n", ltodec(i, blk));
           done = TRUE;
           rc = -1;
         }
@@ -810,10 +1104,17 @@ char *source, *dest;
           rc = -1;
           done = TRUE;
         }
+        else {
+          if (f_verify)
+            crcupd(rwbuffer, BUFFSIZE);
+          if ((i % JBLKS) == 0)
+            /* block is on the local disk - checkpoint */
+            jwrite(TRUE, srcfname, offset + i * BUFFSIZE);
+        }
       }
       /* NUL fill the buffer before last write */
-      for (i=0; i<BUFFSIZE; i++)
-        rwbuffer[i]=0;
+      for (j=0; j<BUFFSIZE; j++)
+        rwbuffer[j]=0;
   
       /* if any extra bytes process them ... */
       if ((nbytes > 0) && !done) {
@@ -826,22 +1127,171 @@ char *source, *dest;
           printf("\nError writing to %s\n", dest);
           rc = -1;
         }
+        else if (f_verify)
+          crcupd(rwbuffer, nbytes);
       } 
       
       /* report results */
-      printf("%-12s\n", dest);
+      printf("%-12s", dest);
 
       /* close file on VDIP */
       vclose(source);
   
       /* close output file */
       fclose(channel);
+
+      /* check the local copy against what was received */
+      if (rc == 0)
+        rc = vpver(0, dest, filesize, offset);
+      printf("\n");
     }
   }
 
   return rc;
 }
 
+/* vccopy - copy a file from one VDIP-1's drive to the
+**  other's (USB: and US2:)
+**
+**  Source: USB file, directory entry e, on device svd
+**  Destination: USB file on device dvd
+**
+**  Nothing is staged on a local disk: each block is read
+**  into a RAM buffer and written straight out. The RDF for
+**  the next block goes to the source before the wait for
+**  the destination to finish writing the last one, so one
+**  VNC1L fetches from its drive while the other writes.
+**
+**  If offset is non-zero the copy resumes at that offset
+**  in both files (see jread()).
+**
+**  Returns:   -1 on error
+**             1 if the source file can't be opened
+*/
+int vccopy(e, dest, svd, dvd, offset)
+int e;
+char *dest;
+struct vdev *svd, *dvd;
+long offset;
+{
+  int n, cur, nblk, rc;
+  long filesize, left, dlen;
+  char *buff;
+  char fsize[15];
+  unsigned d, t;
+
+  rc = 0;
+  filesize = direntry[e]->size;
+  if ((buff = alloc(UUBUFF)) == 0) {
+    printf("Error allocating copy buffer!\n");
+    return -1;
+  }
+
+  /* a resumed copy can only continue from data that
+  ** actually made it to the destination.
+  */
+  if (offset > 0L) {
+    if (vddirf(dvd, dest, &dlen) == -1)
+      dlen = 0L;
+    if (dlen < offset)
+      offset = dlen - (dlen % UUBUFF);
+    if (offset > filesize)
+      offset = 0L;
+  }
+
+  /* the copy keeps the source file's date */
+  d = direntry[e]->mdate;
+  t = direntry[e]->mtime;
+  if (d == 0)
+    settd(FALSE);
+  else {
+    strcpy(td_string, " $");
+    hexcat(td_string, d >> 8);
+    hexcat(td_string, d & 0xFF);
+    hexcat(td_string, t >> 8);
+    hexcat(td_string, t & 0xFF);
+  }
+
+  if (vdropen(svd, srcfname) == -1) {
+    printf("Unable to open source file %s\n", srcfname);
+    rc = 1;
+  }
+  else if (vdwopen(dvd, dest) == -1) {
+    printf("Unable to open destination file %s\n", dest);
+    vdclf(svd);
+    rc = -1;
+  }
+  else {
+    vdseek(dvd, offset);
+    if (offset > 0L)
+      vdseek(svd, offset);
+    printf("%s:%-12s --> ", srcdev, srcfname);
+    if (offset > 0L)
+      printf("(resumed) ");
+
+    if (f_verify)
+      crcbeg();
+    left = filesize - offset;
+    nblk = 0;
+    n = (left > UUBUFF) ? UUBUFF : (int) left;
+    if (n > 0)
+      vdrsend(svd, n);
+    while ((n > 0) && (rc == 0)) {
+      if (vdrget(svd, buff, n) == -1) {
+        printf("\nError reading %s\n", srcfname);
+        rc = -1;
+      }
+      else {
+        left -= n;
+        cur = n;
+        /* start the source on the next block ... */
+        n = (left > UUBUFF) ? UUBUFF : (int) left;
+        if (n > 0)
+          vdrsend(svd, n);
+        /* ... while this one goes to the destination */
+        if (vdmone(dvd, buff, cur) == -1) {
+          printf("\nError writing to VDIP device\n");
+          rc = -1;
+          /* take the block already asked for */
+          if (n > 0)
+            vdrget(svd, buff, n);
+        }
+        else {
+          if (f_verify)
+            crcupd(buff, cur);
+          /* checkpoint now and then; the block just sent
+          ** may still be being written.
+          */
+          if (++nblk == JBLKS) {
+            jwrite(TRUE, srcfname, filesize - left - cur);
+            nblk = 0;
+          }
+        }
+      }
+    }
+    /* wait for the last block to be written */
+    if ((vdmone(dvd, buff, 0) == -1) && (rc == 0)) {
+      printf("\nError writing to VDIP device\n");
+      rc = -1;
+    }
+
+    commafmt(filesize, fsize, 15);
+    printf("%s:%-12s  %s bytes", dstdev, dest, fsize);
+
+    /* close both files */
+    vdclose(svd, srcfname);
+    vdclose(dvd, dest);
+
+    /* read the copy back once and check it */
+    if (rc == 0)
+      rc = vpver(dvd->vd_data, dest, filesize, offset);
+    printf("\n");
+  }
+  free(buff);
+
+  return rc;
+}
+
 /* listmatch - print device directory listing from
 ** stored array (direntry).  Lists only entries with the 
 ** "tag" field set to TRUE.  For USB files the size and
@@ -865,14 +1315,15 @@ int listmatch()
         ++nfiles;
         printf(".%-3s", direntry[i]->ext);
         /* list size and time/date only for USB device */
-        if (srctype == USBD) {
+        if ((srctype == USBD) || (srctype == U2D)) {
           /* files only: display size, date and
           ** time (if non-zero)
           */
           commafmt(direntry[i]->size, fsize, 15);
           printf(" %15s  ", fsize);
 
-          prndate(direntry[i]->mdate);
+          if (direntry[i]->mdate)
+            prndate(direntry[i]->mdate);
           if (direntry[i]->mtime) {
             printf("  ");
             prntime(direntry[i]->mtime);
@@ -890,20 +1341,70 @@ int listmatch()
 ** destination.  Copies only entries with the "tag"
 ** field set to TRUE.
 **
-** NOTE to be added: If destination is a single unique
-** file then just concatenate all files to that, otherwise
-** open source and destination files in pairs.
+** Progress is checkpointed in the journal. The batch
+** stops at the first copy that fails part way so that it
+** can be picked up again with -r; when resuming, files
+** ahead of the one recorded in the journal are skipped.
+** A source file that can't be opened is reported and
+** passed over, since trying it again would not help.
+**
+** If destination is a single unique file and more than
+** one file matches then all files are concatenated to
+** that, otherwise source and destination files are opened
+** in pairs. A resumed concatenation starts over.
 */
 int copyfiles()
 {
-  int i, ncopied;
+  int i, ncopied, nskip, rc;
+  long offset;
   static char fullname[20];
   
+  rc = 0;
+
+  if (isunique() && (ntagged() > 1)) {
+    if ((srctype == U2D) || (dsttype == U2D)) {
+      printf("Can't concatenate between USB drives\n");
+      return;
+    }
+    f_resume = FALSE;
+    if (mirror)
+      printf("Concatenated copies are not mirrored\n");
+    mirror = FALSE;
+    jwrite(TRUE, NULSTR, 0L);
+    dstexpand(direntry[0], &dstspec, dstfname);
+    if ((srctype == STORD) && (dsttype == USBD))
+      rc = catput(dstfname);
+    else {
+      strcpy(fullname, dstdev);
+      strcat(fullname, ":");
+      strcat(fullname, dstfname);
+      rc = catget(fullname);
+    }
+    if (rc == -1)
+      printf("Batch interrupted - use VPIP -R to resume\n");
+    else {
+      printf("\n%d Files Concatenated\n", rc);
+      jwrite(FALSE, NULSTR, 0L);
+    }
+    return;
+  }
+
   /* loop over entries and perform copy */
-  for (i=0, ncopied=0; i<nentries; i++) {
+  for (i=0, ncopied=nskip=0; (i<nentries) && (rc != -1); i++) {
     /* copy tagged files (but not directories!) */
     if(direntry[i]->tag && !direntry[i]->isdir) {
       dirstr(i, srcfname);
+
+      /* when resuming skip ahead to the interrupted file */
+      offset = 0L;
+      if (f_resume) {
+        if (strcmp(srcfname, jsrc) != 0)
+          continue;
+        offset = joffset;
+        f_resume = FALSE;
+      }
+      jwrite(TRUE, srcfname, offset);
+
       if ((srctype == STORD) && (dsttype == USBD)) {
         /* do a "put" (local file --> USB) */
         fullname[0] = NUL;
@@ -911,8 +1412,7 @@ int copyfiles()
         strcat(fullname,":");
         strcat(fullname, srcfname);
         dstexpand(direntry[i], &dstspec, dstfname);
-        if ((vcput(fullname, dstfname)) != -1);
-          ++ncopied;
+        rc = vcput(fullname, dstfname, offset);
       }
       else if ((srctype == USBD) && (dsttype == STORD)){
         /* do a "get" (USB --> local file) */
@@ -921,12 +1421,636 @@ int copyfiles()
         strcat(fullname,":");
         dstexpand(direntry[i], &dstspec, dstfname);
         strcat(fullname, dstfname);
-        if ((vcget(srcfname, fullname)) != -1)
-          ++ncopied;
+        rc = vcget(srcfname, fullname, offset);
+      }
+      else {
+        /* copy from one USB drive to the other */
+        dstexpand(direntry[i], &dstspec, dstfname);
+        if (srctype == U2D)
+          rc = vccopy(i, dstfname, &u2dev, vddef(), offset);
+        else
+          rc = vccopy(i, dstfname, vddef(), &u2dev, offset);
       }
+      if (rc == 0)
+        ++ncopied;
+      else if (rc == 1)
+        ++nskip;
     }
   }
   printf("\n%d Files Copied\n", ncopied);
+  if (nskip > 0)
+    printf("%d File%s could not be opened\n", nskip, (nskip == 1) ? "" : "s");
+
+  if (rc == -1)
+    printf("Batch interrupted - use VPIP -R to resume\n");
+  else if (f_resume)
+    printf("%s not found - nothing to resume\n", jsrc);
+  else
+    /* whole batch done - journal no longer needed */
+    jwrite(FALSE, NULSTR, 0L);
+}
+
+/* isunique - returns TRUE if the destination filespec
+** names a single file (no wild cards).
+*/
+int isunique()
+{
+  int i;
+
+  for (i=0; i<8; i++)
+    if ((dstspec.fname[i] == '?') || (dstspec.fname[i] == '*'))
+      return FALSE;
+  for (i=0; i<3; i++)
+    if ((dstspec.fext[i] == '?') || (dstspec.fext[i] == '*'))
+      return FALSE;
+  return (dstspec.fname[0] != NUL);
+}
+
+/* ntagged - count the tagged files (not directories) */
+int ntagged()
+{
+  int i, n;
+
+  for (i=0, n=0; i<nentries; i++)
+    if (direntry[i]->tag && !direntry[i]->isdir)
+      ++n;
+  return n;
+}
+
+/* padtrim - return the length of the final block of a
+** CP/M text file, up to but not including its ^Z end-of-file
+** mark.  Only the last 128-byte record is searched.
+*/
+int padtrim(buf, n)
+char *buf;
+int n;
+{
+  int i;
+
+  for (i = ((n - 1) / RECSIZE) * RECSIZE; i < n; i++)
+    if (buf[i] == CPMEOF)
+      return i;
+  return n;
+}
+
+/* catput - concatenate the tagged local files into a single
+** USB file.  The destination is opened once and every member
+** is streamed into it back to back, dropping the ^Z padding
+** that ends each CP/M text member.  A block is only known to
+** be the last one of its member once the next read comes back
+** empty, so reads run one block ahead of the writes.
+**
+**  Returns:   number of files copied, -1 on error
+*/
+int catput(dest)
+char *dest;
+{
+  int i, n, nxt, channel, ncat, rc;
+  char *cur, *ahead, *tmp;
+  long total;
+  char fsize[15];
+  static char fullname[20];
+
+  rc = 0;
+  ncat = 0;
+  total = 0L;
+
+  settd(TRUE);
+  if (vwopen(dest) == -1) {
+    printf("Unable to open destination file %s\n", dest);
+    return -1;
+  }
+  vseek(0L);
+
+  for (i=0; (i<nentries) && (rc != -1); i++) {
+    if (direntry[i]->tag && !direntry[i]->isdir) {
+      dirstr(i, srcfname);
+      strcpy(fullname, srcdev);
+      strcat(fullname, ":");
+      strcat(fullname, srcfname);
+      if ((channel = fopen(fullname, "rb")) == 0) {
+        printf("Unable to open source file %s\n", fullname);
+        rc = -1;
+      }
+      else {
+        printf("%-16s --> USB:%s\n", fullname, dest);
+        cur = rwbuffer;
+        ahead = rwbuff2;
+        n = read(channel, cur, BUFFSIZE);
+        while ((n > 0) && (rc != -1)) {
+          nxt = read(channel, ahead, BUFFSIZE);
+          if (nxt == 0)
+            /* last block of this member */
+            n = padtrim(cur, n);
+          if ((n > 0) && (vwrite(cur, n) == -1)) {
+            printf("\nError writing to VDIP device\n");
+            rc = -1;
+          }
+          total += n;
+          tmp = cur;
+          cur = ahead;
+          ahead = tmp;
+          n = nxt;
+        }
+        fclose(channel);
+        ++ncat;
+      }
+#ifndef HDOS
+      /* check for ^C */
+      CtlCk();
+#endif
+    }
+  }
+  vclose(dest);
+
+  commafmt(total, fsize, 15);
+  printf("USB:%-12s  %s bytes\n", dest, fsize);
+
+  return (rc == -1) ? rc : ncat;
+}
+
+/* catget - concatenate the tagged USB files into a single
+** local file.  Each member is read in full blocks, its ^Z
+** padding is dropped and the bytes are packed into rwbuff2
+** so that the local file is still written a block at a time.
+** The result is terminated the way vcget() does it: a final
+** ^Z (CP/M only) and a NUL-filled last block.
+**
+**  Returns:   number of files copied, -1 on error
+*/
+int catget(dest)
+char *dest;
+{
+  int i, j, n, olen, channel, ncat, rc;
+  long filesize, total;
+  char fsize[15];
+
+  rc = 0;
+  ncat = 0;
+  olen = 0;
+  total = 0L;
+
+  if ((channel = fopen(dest, "wb")) == 0) {
+    printf("Error opening destination file %s\n", dest);
+    return -1;
+  }
+
+  for (i=0; (i<nentries) && (rc != -1); i++) {
+    if (direntry[i]->tag && !direntry[i]->isdir) {
+      dirstr(i, srcfname);
+      if ((vdirf(srcfname, &filesize) == -1) || (vropen(srcfname) == -1)) {
+        printf("Unable to open source file %s\n", srcfname);
+        rc = -1;
+      }
+      else {
+        printf("USB:%-12s --> %s\n", srcfname, dest);
+        while ((filesize > 0L) && (rc != -1)) {
+          n = (filesize > BUFFSIZE) ? BUFFSIZE : (int) filesize;
+          filesize -= n;
+          if (vread(rwbuffer, n) == -1) {
+            printf("\nError reading %s\n", srcfname);
+            rc = -1;
+          }
+          else {
+            if (filesize == 0L)
+              n = padtrim(rwbuffer, n);
+            total += n;
+            /* pack into the output block, writing it when full */
+            for (j=0; (j<n) && (rc != -1); j++) {
+              rwbuff2[olen++] = rwbuffer[j];
+              if (olen == BUFFSIZE) {
+                if (write(channel, rwbuff2, BUFFSIZE) == -1) {
+                  printf("\nError writing to %s\n", dest);
+                  rc = -1;
+                }
+                olen = 0;
+              }
+            }
+          }
+        }
+        vclose(srcfname);
+        ++ncat;
+      }
+#ifndef HDOS
+      /* check for ^C */
+      CtlCk();
+#endif
+    }
+  }
+
+  if (rc != -1) {
+#ifndef HDOS
+    /* CP/M text files end with ^Z */
+    if (olen < BUFFSIZE)
+      rwbuff2[olen++] = CPMEOF;
+#endif
+    /* NUL fill and write the final block */
+    if (olen > 0) {
+      for (j=olen; j<BUFFSIZE; j++)
+        rwbuff2[j] = 0;
+      if (write(channel, rwbuff2, BUFFSIZE) == -1) {
+        printf("\nError writing to %s\n", dest);
+        rc = -1;
+      }
+    }
+  }
+  fclose(channel);
+
+  commafmt(total, fsize, 15);
+  printf("%-16s  %s bytes\n", dest, fsize);
+
+  return (rc == -1) ? rc : ncat;
+}
+
+/*********************************************
+**
+**  CP/M Library (.LBR) Functions
+**
+*********************************************/
+
+/* lbrcmd - carry out a command with the -b switch. With a
+** local source the tagged files are packed into the USB
+** library named by the destination.  With a USB source the
+** (single) tagged file is taken to be a library: its members
+** replace the directory and those matching the destination
+** filespec are listed or extracted.
+*/
+int lbrcmd()
+{
+  int i, rc;
+  char *lbr;
+  static char lname[15];
+
+  rc = 0;
+  /* a library is rebuilt from scratch if resumed */
+  f_resume = FALSE;
+
+  if (srctype == STORD) {
+    if (f_list)
+      listmatch();
+    else if (!isunique())
+      printf("Library name must be a single file\n");
+    else {
+      dstexpand(direntry[0], &dstspec, dstfname);
+      if (mirror)
+        printf("Library copies are not mirrored\n");
+      mirror = FALSE;
+      jwrite(TRUE, NULSTR, 0L);
+      if ((rc = lbrput(dstfname)) != -1) {
+        printf("\n%d Files Packed\n", rc);
+        jwrite(FALSE, NULSTR, 0L);
+      }
+    }
+  }
+  else {
+    /* find the library among the tagged files */
+    for (i=0; (i<nentries) && !(direntry[i]->tag && !direntry[i]->isdir); i++)
+      ;
+    if (i == nentries)
+      printf("Library not found\n");
+    else {
+      /* lbrget() uses srcfname for each member */
+      dirstr(i, lname);
+      if ((lbr = lbrdir(lname)) != 0) {
+        domatch(dstspec.fname, dstspec.fext);
+        if (f_list) {
+          listmatch();
+          vbclose();
+        }
+        else
+          lbrget(lname);
+        free(lbr);
+      }
+    }
+  }
+}
+
+/* lbrname - copy a NUL-padded name into a blank-padded
+** LBR directory field of length l.
+*/
+int lbrname(d, s, l)
+char *d, *s;
+int l;
+{
+  int i;
+
+  for (i=0; i<l; i++)
+    *d++ = (*s != NUL) ? *s++ : SPACE;
+}
+
+/* lbrput - pack the tagged local files into a USB library.
+** The directory size follows from the number of files, so
+** space for it is written first, the members are streamed
+** in behind it with a single open, and the completed
+** directory is then written over the placeholder by seeking
+** back to the start of the file.  Member CRCs are left 0.
+**
+**  Returns:   number of files packed, -1 on error
+*/
+int lbrput(dest)
+char *dest;
+{
+  int i, n, nbytes, nent, dirsecs, dirlen, channel, nfiles, rc;
+  unsigned sec;
+  long mlen, total;
+  char *dirbuf;
+  struct lbrent *lde;
+  char fsize[15];
+  static char fullname[20];
+
+  rc = 0;
+  nfiles = 0;
+  total = 0L;
+
+  /* one entry per file plus one for the directory,
+  ** four entries to a sector.
+  */
+  nent = ntagged() + 1;
+  dirsecs = (nent + 3) / 4;
+  dirlen = dirsecs * LBRSEC;
+  if ((dirbuf = alloc(dirlen)) == 0) {
+    printf("Error allocating library directory!\n");
+    return -1;
+  }
+  for (i=0; i<dirlen; i++)
+    dirbuf[i] = 0;
+  lde = (struct lbrent *) dirbuf;
+  for (i=1; i<dirsecs*4; i++)
+    lde[i].lstat = LBRFREE;
+  lbrname(lde[0].lname, NULSTR, 11);
+  lde[0].llen = dirsecs;
+
+  settd(TRUE);
+  if (vwopen(dest) == -1) {
+    printf("Unable to open destination file %s\n", dest);
+    free(dirbuf);
+    return -1;
+  }
+  vseek(0L);
+
+  /* placeholder for the directory */
+  if (vwrite(dirbuf, dirlen) == -1)
+    rc = -1;
+  sec = dirsecs;
+
+  for (i=0, n=1; (i<nentries) && (rc != -1); i++) {
+    if (direntry[i]->tag && !direntry[i]->isdir) {
+      dirstr(i, srcfname);
+      strcpy(fullname, srcdev);
+      strcat(fullname, ":");
+      strcat(fullname, srcfname);
+      if ((channel = fopen(fullname, "rb")) == 0) {
+        printf("Unable to open source file %s\n", fullname);
+        continue;
+      }
+      printf("%-16s --> USB:%s\n", fullname, dest);
+      mlen = 0L;
+      while ((rc != -1) && ((nbytes = read(channel, rwbuffer, BUFFSIZE)) > 0)) {
+        /* members occupy whole sectors */
+        while ((nbytes % LBRSEC) != 0)
+          rwbuffer[nbytes++] = CPMEOF;
+        if (vwrite(rwbuffer, nbytes) == -1) {
+          printf("\nError writing to VDIP device\n");
+          rc = -1;
+        }
+        mlen += nbytes;
+      }
+      fclose(channel);
+
+      lbrname(lde[n].lname, direntry[i]->name, 8);
+      lbrname(lde[n].lext, direntry[i]->ext, 3);
+      lde[n].lstat = 0;
+      lde[n].lindex = sec;
+      lde[n].llen = mlen / LBRSEC;
+      sec += lde[n].llen;
+      total += mlen;
+      ++n;
+      ++nfiles;
+#ifndef HDOS
+      /* check for ^C */
+      CtlCk();
+#endif
+    }
+  }
+
+  /* go back and fill in the real directory */
+  if (rc != -1) {
+    vseek(0L);
+    if (vwrite(dirbuf, dirlen) == -1) {
+      printf("\nError writing library directory\n");
+      rc = -1;
+    }
+  }
+  vclose(dest);
+  free(dirbuf);
+
+  commafmt(total + dirlen, fsize, 15);
+  printf("USB:%-12s  %s bytes\n", dest, fsize);
+
+  return (rc == -1) ? rc : nfiles;
+}
+
+/* lbrdir - read the directory of a USB library and make
+** its active members the directory entries, so they can be
+** matched, listed and extracted like files.  The library is
+** left open for reading through the block cache (vcache),
+** so the directory and small neighbouring members are
+** fetched once, in VBSIZE blocks; close it with vbclose().
+**
+**  Returns:   pointer to the (allocated) directory, 0 on error
+*/
+char *lbrdir(lbr)
+char *lbr;
+{
+  int i, j, dirsecs, nent;
+  char *dirbuf;
+  struct lbrent *lde;
+  struct finfo *entry;
+
+  if (vbopen(lbr, "r") == -1) {
+    printf("Unable to open library %s\n", lbr);
+    return 0;
+  }
+  /* entry 0 gives the size of the directory */
+  if ((vbread(rwbuffer, 32) != 32) || (rwbuffer[0] != 0)) {
+    printf("%s is not a library\n", lbr);
+    vbclose();
+    return 0;
+  }
+  lde = (struct lbrent *) rwbuffer;
+  dirsecs = lde->llen;
+  nent = dirsecs * 4;
+  if ((dirbuf = alloc(dirsecs * LBRSEC)) == 0) {
+    printf("Error allocating library directory!\n");
+    vbclose();
+    return 0;
+  }
+  for (i=0; i<32; i++)
+    dirbuf[i] = rwbuffer[i];
+  vbread(dirbuf+32, dirsecs * LBRSEC - 32);
+
+  /* the library members replace the USB directory */
+  for (i=0; i<nentries; i++)
+    free(direntry[i]);
+  nentries = 0;
+
+  lde = (struct lbrent *) dirbuf;
+  for (i=1; (i<nent) && (nentries<MAXD); i++) {
+    if (lde[i].lstat != 0)
+      continue;
+    if ((entry = alloc(sizeof(struct finfo))) == 0) {
+      printf("Error allocating directory entry!\n");
+      break;
+    }
+    for (j=0; j<8; j++)
+      entry->name[j] = (lde[i].lname[j] == SPACE) ? NUL : lde[i].lname[j];
+    entry->name[8] = NUL;
+    for (j=0; j<3; j++)
+      entry->ext[j] = (lde[i].lext[j] == SPACE) ? NUL : lde[i].lext[j];
+    entry->ext[3] = NUL;
+    entry->isdir = FALSE;
+    entry->tag = FALSE;
+    entry->mdate = 0;
+    entry->mtime = 0;
+    entry->lsec = lde[i].lindex;
+    entry->size = (long) lde[i].llen * LBRSEC;
+    if ((lde[i].lpad & 0xFF) < LBRSEC)
+      entry->size -= lde[i].lpad & 0xFF;
+    direntry[nentries++] = entry;
+  }
+  return dirbuf;
+}
+
+/* lbrget - extract the tagged members of the open library
+** to the destination device.  Each member is located with
+** its directory offset and copied in whole sectors, so the
+** local file is identical to the one that was packed.
+**
+**  Returns:   number of members extracted, -1 on error
+*/
+int lbrget(lbr)
+char *lbr;
+{
+  int i, n, channel, nfiles, rc;
+  long left;
+  static char fullname[20];
+
+  rc = 0;
+  nfiles = 0;
+
+  for (i=0; (i<nentries) && (rc != -1); i++) {
+    if (!direntry[i]->tag)
+      continue;
+    strcpy(fullname, dstdev);
+    strcat(fullname, ":");
+    dstexpand(direntry[i], &dstspec, dstfname);
+    strcat(fullname, dstfname);
+    if ((channel = fopen(fullname, "wb")) == 0) {
+      printf("Error opening destination file %s\n", fullname);
+      continue;
+    }
+    dirstr(i, srcfname);
+    printf("USB:%s[%-12s] --> %s\n", lbr, srcfname, fullname);
+
+    if (vbseek((long) direntry[i]->lsec * LBRSEC) == -1) {
+      printf("\nError seeking in %s\n", lbr);
+      rc = -1;
+    }
+    /* copy whole sectors */
+    left = (direntry[i]->size + LBRSEC - 1) / LBRSEC * LBRSEC;
+    while ((left > 0L) && (rc != -1)) {
+      n = (left > BUFFSIZE) ? BUFFSIZE : (int) left;
+      left -= n;
+      if (vbread(rwbuffer, n) != n) {
+        printf("\nError reading %s\n", lbr);
+        rc = -1;
+      }
+      else if (write(channel, rwbuffer, n) == -1) {
+        printf("\nError writing to %s\n", fullname);
+        rc = -1;
+      }
+    }
+    fclose(channel);
+    ++nfiles;
+#ifndef HDOS
+    /* check for ^C */
+    CtlCk();
+#endif
+  }
+  vbclose();
+  printf("\n%d Files Extracted\n", nfiles);
+
+  return (rc == -1) ? rc : nfiles;
+}
+
+/*********************************************
+**
+**  Checkpoint Journal Functions
+**
+*********************************************/
+
+/* jwrite - record the state of the batch in the journal.
+** The journal is a short text file holding the status
+** (1 = in progress, 0 = complete), the command, the source
+** file being copied and the offset reached in it.
+*/
+int jwrite(status, sname, offset)
+int status;
+char *sname;
+long offset;
+{
+  int chan;
+  static char jpos[12];
+
+  if ((chan = fopen(JFILE, "w")) == 0)
+    printf("\nUnable to write journal %s\n", JFILE);
+  else {
+    fprintf(chan, "%d\n%s\n%s\n%s\n", status, jcmd, sname,
+      ltodec(offset, jpos));
+    fclose(chan);
+  }
+}
+
+/* jread - load the journal of an interrupted batch into
+** jcmd, jsrc and joffset.  Returns 0 if there is a batch
+** to resume, -1 if not.
+*/
+int jread()
+{
+  int chan, rc;
+  static char jline[80];
+
+  rc = -1;
+  if ((chan = fopen(JFILE, "r")) != 0) {
+    jgetl(chan, jline, 80);
+    if (strcmp(jline, "1") == 0) {
+      jgetl(chan, jcmd, 80);
+      jgetl(chan, jsrc, 15);
+      jgetl(chan, jline, 80);
+      joffset = dectol(jline);
+      rc = 0;
+    }
+    fclose(chan);
+  }
+  return rc;
+}
+
+/* jgetl - read a line of at most n-1 characters from a
+** text file, dropping the line ending.
+*/
+int jgetl(chan, s, n)
+int chan;
+char *s;
+int n;
+{
+  int c;
+
+  while (((c = getc(chan)) != -1) && (c != '\n'))
+    if ((c != '\r') && (n > 1)) {
+      *s++ = c;
+      --n;
+    }
+  *s = NUL;
 }
 
 
@@ -948,7 +2072,7 @@ char *dev, *s;
   for (i=0; i<4; i++)
     dev[i] = NUL;
   sfs->fname[0] = NUL;
-  sfs->ext[0] = NUL;
+  sfs->fext[0] = NUL;
   
   /* scan for source drive specification and save it */
   iscan = index(s, ":");
@@ -991,7 +2115,7 @@ char *dev, *s;
 
   /* CP/M stores blanks to the right */
   padblanks(sfs->fname, 8);
-  padblanks(sfs->ext, 3);
+  padblanks(sfs->fext, 3);
 
   /* expand any wild cards in name or extension */
   wcexpand(sfs->fname, 8);
@@ -1026,6 +2150,8 @@ char *d;
     dtype = NULLD;
   else if (strcmp(d, "USB") == 0)
     dtype = USBD;
+  else if (strcmp(d, "US2") == 0)
+    dtype = U2D;
 #ifdef HDOS
   /* HDOS has 2 or 3 letters, e.g. TT: or SY0: */
   else if ((strlen(d) == 2) && isalpha(d[0]) && isalpha(d[1]))
@@ -1050,7 +2176,7 @@ char *d;
 **    0: normal return, no error
 **    1: one or more unknown devices specified
 **    2: no USB device specified
-**    3: both source and dest are USB (not allowed)
+**    3: source and dest are the same USB drive (not allowed)
 **    4: one or both devices are user devices (e.g. TT: LP:, etc.)
 */
 int checkdev()
@@ -1111,8 +2237,8 @@ int checkdev()
   if ((dsttype != USBD) && (srctype != USBD))
     rc = 2;
   
-  /* USB to USB copies not supported */
-  if ((dsttype == USBD) && (srctype == USBD))
+  /* USB to USB copies must be between USB: and US2: */
+  if ((dsttype == srctype) && ((dsttype == USBD) || (dsttype == U2D)))
     rc = 3;
   
   /* currently only disk devices allowed */
@@ -1168,10 +2294,13 @@ int docmd(s)
 char *s;
 {
   char *srcstr, *dststr;
-  int i, iscan, rc;
+  int i, iscan, rc, port;
   struct fspec *entry;
   char tmpdev[4];
 
+  /* keep an intact copy of the command for the journal */
+  strcpy(jcmd, s);
+
   *dstdev = NUL;
   *srcdev = NUL;
   *tmpdev = NUL;
@@ -1238,13 +2367,26 @@ char *s;
       rc = 6;
       printf("No flash drive found!\n");
     }
+    /* puts may be mirrored to a second VDIP-1 */
+    else if ((mirror = f_mirror && (dsttype == USBD) && (srctype == STORD) &&
+             !f_list) && (mirinit() == -1))
+      rc = 7;
+    /* US2: is the drive on the second VDIP-1 */
+    else if (((srctype == U2D) || (dsttype == U2D)) && (u2init() == -1))
+      rc = 8;
     else {
       /* build directory and tag matching files */
-      if ((srctype == STORD) || (srctype == USBD)) {
+      if ((srctype == STORD) || (srctype == USBD) || (srctype == U2D)) {
         /* first build the directory tree in memory */
         if (srctype == STORD)
           /* build local directory */
           bldldir(srcdev);
+        else if (srctype == U2D) {
+          /* build US2: directory, through the global API */
+          port = vport(uport);
+          bldudir();
+          vport(port);
+        }
         else
           /* build USB directory */
           bldudir();
@@ -1252,7 +2394,11 @@ char *s;
         for (i=0; i<nsrc; i++)
           domatch(src[i]->fname, src[i]->fext);
       }
-      if (f_list)
+      if (f_lbr && ((srctype == U2D) || (dsttype == U2D)))
+        printf("Library copies to or from US2: not supported\n");
+      else if (f_lbr)
+        lbrcmd();
+      else if (f_list)
         listmatch();
       else
         copyfiles();
@@ -1263,7 +2409,7 @@ char *s;
   else if (rc == 2)
     printf("Either source or destination need to be the USB\n");
   else if (rc == 3)
-    printf("USB to USB copies not supported\n");
+    printf("USB to USB copies need US2: on a second VDIP-1\n");
   else if (rc == 4)
     printf("Both source and destination must be storage devices\n");
   else
@@ -1286,6 +2432,9 @@ int freeall()
     free(direntry[i]);
 }
 
+/* show USB statistics at exit (-s) */
+int f_stats;
+
 /* process switches */
 int dosw(argc, argv)
 int argc;
@@ -1297,6 +2446,7 @@ char *argv[];
   /* default flag settings */
   f_list = FALSE;
   verbose = FALSE;
+  f_resume = FALSE;
 
   /* process right to left */
   for (i=argc; i>0; i--) {
@@ -1304,6 +2454,10 @@ char *argv[];
     if (*s++ == '-') {
       /* have a switch! */
       switch (*s) {
+      /* S = show USB statistics at exit */
+      case 'S':
+        f_stats = TRUE;
+        break;
       /* P = specify alternate I/O port */
       case 'P':
         ++s;
@@ -1318,6 +2472,33 @@ char *argv[];
       case 'V':
         verbose = TRUE;
         break;
+      /* R = resume interrupted batch */
+      case 'R':
+        f_resume = TRUE;
+        break;
+      /* B = USB file is an .LBR library */
+      case 'B':
+        f_lbr = TRUE;
+        break;
+      /* K = check (verify) each copy */
+      case 'K':
+        f_verify = TRUE;
+        break;
+      /* A = append to the USB file */
+      case 'A':
+        f_append = TRUE;
+        break;
+      /* U = port of the second VDIP-1 (US2:) */
+      case 'U':
+        ++s;
+        uport = aotoi(s);
+        break;
+      /* M = mirror puts to a second VDIP-1 */
+      case 'M':
+        ++s;
+        mport = aotoi(s);
+        f_mirror = TRUE;
+        break;
       default:
           printf("Invalid switch %c\n", *s);
         break;
@@ -1335,6 +2516,7 @@ char *argv[];
   /* default port values */
   p_data = VDATA;
   p_stat = VSTAT;
+  uport = U2PORT;
   
   /* set globals 'os' and 'osver' to direct use of time and
   ** date functions
@@ -1355,12 +2537,24 @@ char *argv[];
 
   /* process any switches */
   dosw(argc, argv);
+  if (f_verify)
+    crcini();
 
   if (verbose)
     printf("VPIP v%s, using %s port: [%o]\n", VERSION,
       (userport ? "user-specified" : "default"), p_data);
   
-  if (argc < 2) {
+  if (f_resume) {
+    /* re-run the batch recorded in the journal */
+    if (jread() == -1)
+      printf("No interrupted batch in %s\n", JFILE);
+    else {
+      printf("Resuming %s at %s\n", jcmd, jsrc);
+      strcpy(cmdline, jcmd);
+      docmd(cmdline);
+    }
+  }
+  else if (argc < 2) {
     /* interactive mode */
     do {
       printf(":V:");
@@ -1374,4 +2568,6 @@ char *argv[];
   else
     /* command line mode */
     docmd(argv[1]);
+  if (f_stats)
+    vstats();
 }
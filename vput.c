@@ -7,16 +7,31 @@
 **
 ** Usage: 
 **
-**  vput file1 {file2} {file3} ... {-pxxx}
+**  vput file1 {file2} {file3} ... {-a} {-k} {-mxxx} {-pxxx}
 **
 ** "wildcard" expansion with "*" and "?" are supported
 **
 ** switches:
+**    -a to append: only the part of each file beyond the
+**       length of the existing USB copy is sent (all of
+**       it if the local file is now the shorter)
+**    -k to verify each copy: a checksum is kept of the bytes
+**       sent, and the USB file is then read back once and
+**       checked against it
+**    -s to show USB transfer statistics at exit
+**    -mxxx to write a mirror copy of each file to the USB
+**       drive on a second VDIP-1 at octal port xxx
 **    -pxxx to specify octal port (default is 0331)
 **
+** With -m each block read from the local file is written to
+** both drives, the second VNC1L receiving the block while
+** the first writes it to its drive, so the two copies take
+** little longer than one. Appending (-a) starts from the
+** shorter of the two USB files, and -k checks both copies.
+**
 ** Compiled with Software Toolworks C/80 V. 3.1.
 **
-** L80 vput,vinc,vutil,pio,fprintf,scanf,command,flibrary/s,stdlib/s,clibrary/s,vput/n/e
+** L80 vput,vcrc,crc,vinc,vutil,pio,fprintf,scanf,command,seek,flibrary/s,stdlib/s,clibrary/s,vput/n/e
 **
 ** This code uses ifndef to insert calls to CtlCk(), which 
 ** is necessary in CP/M to check for CTRL-C interrupts, and 
@@ -39,6 +54,13 @@
 ** 27 October 2024 - added ability to read port number from
 ** configuration file. Updated to V4.1.
 **
+** 18 October 2026 - "-k" verifies each copy as it is made.
+**
+** 18 October 2026 - "-a" appends to growing files.
+**
+** 18 October 2026 - "-m" mirrors the copies to a second
+** VDIP-1.
+**
 ********************************************************/
 #include "fprintf.h"
 
@@ -46,12 +68,37 @@
 #define EXTERN
 #include "vutil.h"
 #include "vinc.h"
+#include "vcrc.h"
 
 #define BUFFSIZE  256
 
 /* buffer used for read/write */
 char rwbuffer[BUFFSIZE];
 
+/* verify copies (-k) */
+int f_verify;
+
+/* append to USB files (-a) */
+int f_append;
+
+/* mirror to a second VDIP-1 (-m) */
+int f_mirror;
+int mport;              /* its data port */
+struct vdev mirdev;
+char mirline[128];      /* its line buffer */
+
+/* mirinit - set up the mirror VDIP-1 (-m)
+**
+**  Returns:   -1 on error
+*/
+int mirinit()
+{
+  if (vdsetup(&mirdev, mport, mirline) == -1)
+    return -1;
+  printf("Mirroring to port: [%o]\n", mport);
+  return 0;
+}
+
 /* vcput - copy from CP/M or HDOS source file to 
 ** USB: destination file
 **
@@ -61,7 +108,7 @@ int vcput(source, dest)
 char *source, *dest;
 {
   int nbytes, channel, done, rc;
-  long filesize;
+  long filesize, offset, moff;
   long fsize[15];
   
   rc = 0;
@@ -71,6 +118,22 @@ char *source, *dest;
     rc = -1;
   }
   else {
+    /* append after what the shorter USB copy holds; if
+    ** that has to start over the old copies are replaced.
+    */
+    offset = 0L;
+    if (f_append) {
+      offset = vapoff(dest, channel);
+      if (f_mirror && (offset > 0L) &&
+          ((moff = vdapoff(&mirdev, dest, channel)) < offset))
+        offset = moff;
+      if (offset == 0L) {
+        vdlf(dest);
+        if (f_mirror)
+          vddlf(&mirdev, dest);
+      }
+    }
+
     /* first set up the file date for vwopen() */
     settd(TRUE);
     
@@ -80,13 +143,29 @@ char *source, *dest;
       rc = -1;
       fclose(channel);
     }
+    else if (f_mirror && (vdwopen(&mirdev, dest) == -1)) {
+      printf("Unable to open mirror file %s\n", dest);
+      vclose(dest);
+      rc = -1;
+      fclose(channel);
+    }
     else {
-      /* start writing at beginning of file */
-      vseek(0);
-      filesize = 0L;
+      /* start writing at beginning of file, or at the
+      ** part still to be sent if appending.
+      */
+      vseek(offset);
+      if (f_mirror)
+        vdseek(&mirdev, offset);
+      if (offset > 0L)
+        lseekl(channel, offset);
+      filesize = offset;
       printf("%-16s --> ", source);
+      if (offset > 0L)
+        printf("(appended) ");
 
       /* copy one block at a time */
+      if (f_verify)
+        crcbeg();
       done = FALSE;
       while (!done) {
         nbytes = read(channel, rwbuffer, BUFFSIZE);
@@ -94,28 +173,60 @@ char *source, *dest;
         if (nbytes == 0) {
           done = TRUE;
         }
-        else if (vwrite(rwbuffer, nbytes) == -1) {
+        else if (f_mirror ? (vdmwrite(vddef(), &mirdev, rwbuffer, nbytes) == -1) :
+                 (vwrite(rwbuffer, nbytes) == -1)) {
           printf("Error writing to VDIP device\n");
           rc = -1;
             done = TRUE;
         } 
+        else if (f_verify)
+          crcupd(rwbuffer, nbytes);
+      }
+      /* wait for the last block on both drives */
+      if (f_mirror && (vdmwrite(vddef(), &mirdev, rwbuffer, 0) == -1) &&
+          (rc == 0)) {
+        printf("Error writing to VDIP device\n");
+        rc = -1;
       }
       /* report results */
       commafmt(filesize, fsize, 15);
-      printf("USB:%-12s  %s bytes\n", dest, fsize);
+      printf("USB:%-12s  %s bytes", dest, fsize);
       
       /* important - close file on VDIP */
       vclose(dest);
+      if (f_mirror) {
+        vdclose(&mirdev, dest);
+        printf(" (mirrored)");
+      }
+
+      /* read the copy back once and check it; an
+      ** appended copy can't be checked this way.
+      */
+      if (f_verify && (rc == 0) && (offset > 0L))
+        printf("  (not verified)");
+      else if (f_verify && (rc == 0)) {
+        if ((crcver(TRUE, dest, filesize) == -1) ||
+            (f_mirror && (crcpver(mport, dest, filesize) == -1))) {
+          printf("  ** VERIFY FAILED **");
+          rc = -1;
+        }
+        else
+          printf("  verified");
+      }
+      printf("\n");
+
+      /* close input file */
+      fclose(channel);
     }
-    
-    /* close input file */
-    fclose(channel);
   }
     
   return rc;
 }
 
 
+/* show USB statistics at exit (-s) */
+int f_stats;
+
 /* dosw - process any switches on the command line.
 ** Switches are preceded by "-".  If a numeric value
 ** is given there should be no space, for example:
@@ -139,6 +250,20 @@ char *argv[];
     if (*s++ == '-') {
       /* have a switch! */
       switch (*s) {
+      case 'A':
+        f_append = TRUE;
+        break;
+      case 'K':
+        f_verify = TRUE;
+        break;
+      case 'S':
+        f_stats = TRUE;
+        break;
+      case 'M':
+        ++s;
+        mport = aotoi(s);
+        f_mirror = TRUE;
+        break;
       case 'P':
         ++s;
         p_data = aotoi(s);
@@ -188,16 +313,24 @@ char *argv[];
   printf("Using port: [%o]\n", p_data);
 
   if (argc < 2) {
-    printf("Usage: VPUT file {file} {file} ... <-pxxx>\n");
+    printf("Usage: VPUT file {file} {file} ... <-a> <-k> <-mxxx> <-pxxx>\n");
     printf("\tlocal is local drive and/or filespec\n");
+    printf("\t-a to append to existing USB files\n");
+    printf("\t-k to verify each copy\n");
+    printf("\t-s to show USB statistics at exit\n");
+    printf("\t-mxxx to mirror to a second VDIP-1 at octal port xxx\n");
     printf("\txxx is USB optional port in octal (default is %o)\n", VDATA);
   }
   else if (vinit() == -1)
     printf("Error initializing VDIP-1 device!\n");
   else if (vfind_disk() == -1)
     printf("No flash drive found!\n");
+  else if (f_mirror && (mirinit() == -1))
+    ;
   else {
     /* all is good copy the file(s) */
+    if (f_verify)
+      crcini();
     for (i=1; i<argc; i++) {
 #ifndef HDOS
       /* check for ^C */
@@ -216,4 +349,6 @@ char *argv[];
       }
     }
   }
+  if (f_stats)
+    vstats();
 }
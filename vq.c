@@ -0,0 +1,103 @@
+/********************************************************
+** vq - Version 4.3 for MP/M II
+**
+** This program submits a copy job to VBG, the background
+** transfer process, and shows the messages VBG has posted
+** since it was last run.
+**
+** Usage: vq {PUT d:file.ext {name.ext}}
+**        vq {GET file.ext {d:}{name.ext}}
+**        vq {QUIT}
+**
+** e.g. "VQ PUT A:REPORT.TXT" queues a copy of A:REPORT.TXT
+** to the USB drive and returns at once; "VQ" on its own
+** then shows "start", "done" or "FAILED" for each job as
+** VBG gets to it. If VBG already has VQNMSG jobs waiting
+** VQ waits for room in the queue. QUIT stops VBG once the
+** jobs ahead of it are done.
+**
+** Compiled with Software Toolworks C/80 V. 3.1 with support for
+** floats and longs.  Typical link statement:
+**
+** L80 vq,vutil,pio,fprintf,seek,flibrary/s,stdlib/s,clibrary/s,vq/n/e
+**
+** 18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+
+/* ensure globals live here */
+#define EXTERN
+#include "vutil.h"
+#include "vinc.h"       /* globals used by vutil */
+#include "vbg.h"
+
+struct uqcb ujob, ustat;
+char jmsg[VQMSG];
+char smsg[VQMSG];
+
+/* openq - open queue name for messages in buf
+**
+**  Returns:   -1 if there is no such queue
+*/
+int openq(uq, name, buf)
+struct uqcb *uq;
+char *name, *buf;
+{
+  strncpy(uq->uq_name, name, 8);
+  uq->uq_msg = buf;
+  return ((bdoshl(OPENQ, uq) & 0xFF) == 0) ? 0 : -1;
+}
+
+/* submit - build the job from the arguments and queue it
+**
+**  Returns:   -1 if it is not a job VBG knows
+*/
+int submit(argc, argv)
+int argc;
+char *argv[];
+{
+  int i;
+
+  if ((strcmp(argv[1], "QUIT") != 0) &&
+      (((strcmp(argv[1], "PUT") != 0) && (strcmp(argv[1], "GET") != 0)) ||
+       (argc < 3) || (argc > 4)))
+    return -1;
+  jmsg[0] = NUL;
+  for (i=1; i<argc; i++) {
+    if ((strlen(jmsg) + strlen(argv[i]) + 2) > VQMSG)
+      return -1;
+    if (i > 1)
+      strcat(jmsg, " ");
+    strcat(jmsg, argv[i]);
+  }
+  bdoshl(WRITEQ, &ujob);
+  printf("Queued: %s\n", jmsg);
+  return 0;
+}
+
+main(argc,argv)
+int argc;
+char *argv[];
+{
+  int n;
+
+  getosver();
+  if (os != OSMPM)
+    printf("VQ runs only under MP/M II\n");
+  else if ((openq(&ujob, JOBQ, jmsg) == -1) ||
+           (openq(&ustat, STATQ, smsg) == -1))
+    printf("VBG is not running\n");
+  else if ((argc > 1) && (submit(argc, argv) == -1)) {
+    printf("Usage: VQ <PUT d:file.ext <name.ext>>\n");
+    printf("       VQ <GET file.ext <d:><name.ext>>\n");
+    printf("       VQ <QUIT>\n");
+  }
+  else {
+    /* show what VBG has done */
+    for (n=0; (bdoshl(CREADQ, &ustat) & 0xFF) == 0; n++)
+      printf("%s\n", smsg);
+    if ((n == 0) && (argc == 1))
+      printf("No news from VBG\n");
+  }
+}
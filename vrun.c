@@ -0,0 +1,453 @@
+/********************************************************
+** vrun - Version 4.3 for CP/M and HDOS
+**
+** This program loads a program file directly from the USB
+** flash drive into memory and runs it, without first copying
+** it to a local disk.
+**
+** Usage: vrun {-pxxx} program {arguments ...}
+**
+**    'program' is the name of a .COM file (CP/M) or .ABS
+**    file (HDOS) on the USB drive; the extension may be
+**    omitted. Anything after the program name is passed to
+**    the program as its command tail (CP/M only), so the
+**    switches for vrun itself must come first.
+**
+**    switches:
+**      -pxxx to specify octal port (default is 0261)
+**
+** Under CP/M the file is loaded at 0100H, the command tail
+** is placed at 0080H and the default FCBs at 005CH and 006CH
+** are set up from the first two arguments, just as the CCP
+** would do. Under HDOS the .ABS header gives the load
+** address, length and entry point. HDOS programs are run
+** with no command line.
+**
+** Since the program overwrites vrun itself, the actual load
+** is done by a small loader which is first copied up to high
+** memory, just below the stack. It sends a single RDF for
+** the whole file, takes the bytes straight from the VDIP1
+** ports into memory and then jumps to the entry point.  The
+** file is left open on the VDIP1; all of the vinc open
+** routines close any open file first.
+**
+** Compiled with Software Toolworks C/80 V. 3.1 with support for
+** floats and longs.  Typical link statement:
+**
+** L80 vrun,vinc,vutil,pio,fprintf,seek,flibrary/s,stdlib/s,clibrary/s,vrun/n/e
+**
+** Our convention is to save all files with CP/M style
+** line endings (CR-LF). The HDOS version of C/80 is picky
+** and wants to see just LF (which is the HDOS standard line ending,
+** therefore the CR characters must be stripped out before compilation.
+** A separate STRIP.C program provides this capability.
+**
+** 18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+
+/* ensure globals live here */
+#define EXTERN
+#include "vutil.h"
+#include "vinc.h"
+
+#define FSLEN   20
+
+/* offsets of the loader data fields */
+#define VRCNT   3       /* bytes to load */
+#define VRLOD   5       /* load address */
+#define VRENT   7       /* entry point */
+#define VRCMD   9       /* RDF command string */
+
+#ifdef HDOS
+#define USERFWA 0x2280  /* first user address */
+#define ABSHDR  8       /* size of .ABS header */
+#else
+#define TPA     0x0100
+#define TBUFF   0x0080  /* command tail */
+#define FCB1    0x005C  /* default FCBs */
+#define FCB2    0x006C
+#endif
+
+/* name of program file on USB drive */
+char progname[FSLEN];
+
+/* index of program name in argv */
+int iprog;
+
+/* dosw - process switches on the command line. Unlike
+** the other utilities the switches come before the
+** program name, since everything after it belongs to
+** the program being run. Sets iprog to the index of
+** the program name (or argc if there is none).
+*/
+dosw(argc, argv)
+int argc;
+char *argv[];
+{
+  char *s;
+
+  for (iprog=1; iprog<argc; iprog++) {
+    s = argv[iprog];
+    if (*s++ != '-')
+      break;
+    switch (*s) {
+    case 'P':
+      ++s;
+      p_data = aotoi(s);
+      p_stat = p_data + 1;
+      break;
+    default:
+      printf("Invalid switch %c\n", *s);
+      break;
+    }
+  }
+}
+
+/* vrinfo - returns the address of a table describing the
+** loader: its address, length, and the addresses of three
+** zero-terminated lists of offsets within it - operands
+** to be relocated, status port operands and data port
+** operands.
+**
+** The loader sends the NUL-terminated command at VRCMD,
+** reads VRCNT bytes into memory starting at VRLOD, eats
+** the prompt and jumps to VRENT with its stack just
+** below itself and a return address of 0 on the stack.
+*/
+int *vrinfo()
+{
+#asm
+        LXI     H,VRTAB
+        RET
+VRTAB:  DW      VRSTB,VRSTE-VRSTB,VRREL,VRPST,VRPDT
+;
+VRSTB:
+VRA1:   JMP     VRGO
+        DW      0               ; VRCNT
+        DW      0               ; VRLOD
+        DW      0               ; VRENT
+        DS      16              ; VRCMD
+VRGO:
+VRA2:   LXI     SP,VRSTB
+VRA3:   LXI     H,VRSTB+9
+VRSND:  MOV     A,M             ; send the command
+        ORA     A
+VRA4:   JZ      VRRD
+VRTX:   IN      0
+        ANI     4               ; VTXE
+VRA5:   JZ      VRTX
+        MOV     A,M
+VRTD:   OUT     0
+        INX     H
+VRA6:   JMP     VRSND
+VRRD:
+VRA7:   LHLD    VRSTB+3         ; DE = count
+        XCHG
+VRA8:   LHLD    VRSTB+5         ; HL = load address
+VRNXT:  MOV     A,D
+        ORA     E
+VRA9:   JZ      VRDRN
+VRRX:   IN      0
+        ANI     8               ; VRXF
+VRA10:  JZ      VRRX
+VRRD1:  IN      0
+        MOV     M,A
+        INX     H
+        DCX     D
+VRA11:  JMP     VRNXT
+VRDRN:  IN      0               ; eat the prompt
+        ANI     8
+VRA12:  JZ      VRDRN
+VRRD2:  IN      0
+        CPI     0DH
+VRA13:  JNZ     VRDRN
+        LXI     H,0
+        PUSH    H
+VRA14:  LHLD    VRSTB+7
+        PCHL
+VRSTE:
+;
+VRREL:  DW      VRA1+1-VRSTB,VRA2+1-VRSTB,VRA3+1-VRSTB,VRA4+1-VRSTB
+        DW      VRA5+1-VRSTB,VRA6+1-VRSTB,VRA7+1-VRSTB,VRA8+1-VRSTB
+        DW      VRA9+1-VRSTB,VRA10+1-VRSTB,VRA11+1-VRSTB
+        DW      VRA12+1-VRSTB,VRA13+1-VRSTB,VRA14+1-VRSTB,0
+VRPST:  DW      VRTX+1-VRSTB,VRRX+1-VRSTB,VRDRN+1-VRSTB,0
+VRPDT:  DW      VRTD+1-VRSTB,VRRD1+1-VRSTB,VRRD2+1-VRSTB,0
+#endasm
+}
+
+/* vrsp - returns the current stack pointer */
+int vrsp()
+{
+#asm
+        LXI     H,0
+        DAD     SP
+#endasm
+}
+
+/* vrjump - jump to the loader at address a. Does not
+** return.
+*/
+vrjump(a)
+char *a;
+{
+#asm
+        POP     H
+        POP     H
+        PCHL
+#endasm
+}
+
+/* vrputw - store 16-bit value v at address p */
+vrputw(p, v)
+char *p;
+unsigned v;
+{
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+}
+
+/* vrgetw - fetch 16-bit value from address p */
+unsigned vrgetw(p)
+char *p;
+{
+  return (p[0] & 0xFF) | ((p[1] & 0xFF) << 8);
+}
+
+/* setldr - copy the loader to dest and fill in its
+** ports and parameters.
+*/
+setldr(dest, count, load, entry)
+char *dest;
+unsigned count, load, entry;
+{
+  int *tab, *r;
+  char *src;
+  unsigned len, delta;
+
+  tab = vrinfo();
+  src = tab[0];
+  len = tab[1];
+  delta = dest - src;
+
+  while (len-- > 0)
+    *dest++ = *src++;
+  dest -= tab[1];
+
+  for (r = tab[2]; *r != 0; r++)
+    vrputw(dest + *r, vrgetw(dest + *r) + delta);
+  for (r = tab[3]; *r != 0; r++)
+    dest[*r] = p_stat;
+  for (r = tab[4]; *r != 0; r++)
+    dest[*r] = p_data;
+
+  vrputw(dest + VRCNT, count);
+  vrputw(dest + VRLOD, load);
+  vrputw(dest + VRENT, entry);
+  strcpy(dest + VRCMD, "rdf ");
+  ltodec((long) count & 0xFFFFL, dest + VRCMD + 4);
+  strcat(dest + VRCMD, "\r");
+}
+
+#ifndef HDOS
+/* setfcb - fill in a default FCB from argument s (which
+** may be 0), as the CCP would.
+*/
+setfcb(s, f)
+char *s, *f;
+{
+  int i;
+
+  f[0] = 0;
+  for (i=1; i<12; i++)
+    f[i] = ' ';
+  for (i=12; i<16; i++)
+    f[i] = 0;
+  if (s == 0)
+    return;
+  if ((*s != NUL) && (s[1] == ':')) {
+    f[0] = toupper(*s) - 'A' + 1;
+    s += 2;
+  }
+  for (i=1; (*s != NUL) && (*s != '.'); s++) {
+    if (*s == '*') {
+      while (i < 9)
+        f[i++] = '?';
+    }
+    else if (i < 9)
+      f[i++] = toupper(*s);
+  }
+  if (*s == '.') {
+    for (i=9, ++s; *s != NUL; s++) {
+      if (*s == '*') {
+        while (i < 12)
+          f[i++] = '?';
+      }
+      else if (i < 12)
+        f[i++] = toupper(*s);
+    }
+  }
+}
+
+/* settail - build the command tail at TBUFF and the
+** default FCBs from the arguments following the
+** program name.
+*/
+settail(argc, argv)
+int argc;
+char *argv[];
+{
+  char *t;
+  int i, n;
+
+  t = TBUFF + 1;
+  n = 0;
+  for (i=iprog+1; i<argc; i++) {
+    if (n + strlen(argv[i]) + 1 > 126)
+      break;
+    t[n++] = ' ';
+    strcpy(t + n, argv[i]);
+    n += strlen(argv[i]);
+  }
+  t[n] = NUL;
+  *(t - 1) = n;
+
+  setfcb((iprog+1 < argc) ? argv[iprog+1] : 0, FCB1);
+  setfcb((iprog+2 < argc) ? argv[iprog+2] : 0, FCB2);
+}
+#endif
+
+/* vrload - open the program on the USB drive and set up
+** the loader. Returns the loader address, or 0 if the
+** program can't be loaded.
+*/
+char *vrload(argc, argv)
+int argc;
+char *argv[];
+{
+  long len;
+  unsigned count, load, entry, dest;
+  int *tab;
+#ifdef HDOS
+  char hdr[ABSHDR];
+#endif
+
+  if (vdirf(progname, &len) == -1) {
+    printf("%s not found\n", progname);
+    return 0;
+  }
+  if (vropen(progname) == -1) {
+    printf("Unable to open %s\n", progname);
+    return 0;
+  }
+
+#ifdef HDOS
+  if ((len <= ABSHDR) || (vread(hdr, ABSHDR) == -1) ||
+      ((hdr[0] & 0xFF) != 0xFF) || (hdr[1] != 0)) {
+    printf("%s is not an absolute binary file\n", progname);
+    vclf();
+    return 0;
+  }
+  load = vrgetw(hdr+2);
+  count = vrgetw(hdr+4);
+  entry = vrgetw(hdr+6);
+  if ((load < USERFWA) || ((long) count > len - ABSHDR)) {
+    printf("Bad load address or length in %s\n", progname);
+    vclf();
+    return 0;
+  }
+#else
+  if (len == 0L) {
+    printf("%s is empty\n", progname);
+    vclf();
+    return 0;
+  }
+  load = TPA;
+  entry = TPA;
+  count = (len > 0xFF00L) ? 0xFF00 : (unsigned) len;
+#endif
+
+  /* put the loader on a page boundary below the stack,
+  ** leaving room for the stack we're now using.
+  */
+  tab = vrinfo();
+  dest = (vrsp() - 256 - tab[1]) & 0xFF00;
+
+  /* leave room for the program's initial stack */
+  if ((len > 0xFF00L) || (count > dest - 128 - load)) {
+    printf("%s is too large to load\n", progname);
+    vclf();
+    return 0;
+  }
+
+  setldr(dest, count, load, entry);
+#ifndef HDOS
+  settail(argc, argv);
+#endif
+  return dest;
+}
+
+main(argc,argv)
+int argc;
+char *argv[];
+{
+  int userport;
+  char *ldr;
+
+  printf("VRUN v%s, ", VERSION);
+
+  /* Set default values */
+  p_data = VDATA;
+  p_stat = VSTAT;
+
+  /* set globals 'os' and 'osver' */
+  getosver();
+
+	/* check if user has a file specifying the port. For
+	** HDOS we can provide the location of this program executable
+	** but for CP/M we can only suggest looking on A:
+	*/
+#ifdef HDOS
+	userport = chkport("SY0:");
+#else
+	userport = chkport("A:");
+#endif
+
+  /* process any switches and set defaults */
+  dosw(argc, argv);
+
+  printf("using %s port: [%o]\n", (userport ? "user-specified" : "default"), p_data);
+
+  if (iprog >= argc) {
+    printf("Usage: VRUN <-pxxx> usbprog {arguments}\n");
+#ifdef HDOS
+    printf("\tusbprog is an .ABS file on the USB drive\n");
+#else
+    printf("\tusbprog is a .COM file on the USB drive\n");
+#endif
+    printf("\txxx is USB optional port in octal (default is %o)\n", VDATA);
+  }
+  else if (vinit() == -1)
+    printf("Error initializing VDIP-1 device!\n");
+  else if (vfind_disk() == -1)
+    printf("No flash drive found!\n");
+  else {
+    strncpy(progname, argv[iprog], FSLEN-5);
+    progname[FSLEN-5] = NUL;
+    if (index(progname, ".") == -1)
+#ifdef HDOS
+      strcat(progname, ".ABS");
+#else
+      strcat(progname, ".COM");
+#endif
+    if ((ldr = vrload(argc, argv)) != 0) {
+#ifndef HDOS
+      /* reset the DMA address to the command tail buffer */
+      bdos(26, TBUFF);
+#endif
+      vrjump(ldr);
+    }
+  }
+}
@@ -0,0 +1,454 @@
+/********************************************************
+** vsum - Version 4.3 for CP/M and HDOS
+**
+** This program computes CRC-32 and CRC-16 checksums of
+** files on the USB flash drive or local files, and can
+** save them in a manifest file on the USB drive or check
+** files against one.
+**
+** Usage: vsum file {file} ... {-l} {-w} {-mname} {-pxxx}
+**        vsum -c {file} ... {d:} {-l} {-mname} {-pxxx}
+**
+**    'file' is the name of a file on the USB drive, or a
+**    pattern using the "*" and "?" wild cards, which is
+**    matched against the USB directory.  With -l it is the
+**    name of a local file (no wild cards).
+**
+**    switches:
+**      -l checksum local files instead of USB files
+**      -w write the results to the manifest on the USB drive
+**      -c check files against the manifest. If no files are
+**         given all files in the manifest are checked,
+**         otherwise only those matching the names given.
+**         With -l the local copies are checked, on drive d:
+**         if one is given.
+**      -mname manifest file name (default VSUM.CRC)
+**      -s to show USB transfer statistics at exit
+**      -pxxx to specify octal port (default is 0261)
+**
+** Each line of the manifest holds the CRC-32, CRC-16,
+** length and name of a file, e.g.
+**
+**    CBF43926 31C3 9 TEST.TXT
+**
+** Local files are a whole number of records, so when a
+** local copy is checked only as many bytes as the manifest
+** gives for the original are checksummed.
+**
+** Compiled with Software Toolworks C/80 V. 3.1 with support for
+** floats and longs.  Typical link statement:
+**
+** L80 vsum,vcrc,crc,vfile,vinc,vutil,pio,fprintf,seek,flibrary/s,stdlib/s,clibrary/s,vsum/n/e
+**
+** Our convention is to save all files with CP/M style
+** line endings (CR-LF). The HDOS version of C/80 is picky
+** and wants to see just LF (which is the HDOS standard line ending,
+** therefore the CR characters must be stripped out before compilation.
+** A separate STRIP.C program provides this capability.
+**
+** 18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+
+/* ensure globals live here */
+#define EXTERN
+#include "vutil.h"
+#include "vinc.h"
+#include "vfile.h"
+#include "vcrc.h"
+
+#define FSLEN   20
+#define MAXF    128     /* most files in one run */
+#define MANIFEST "VSUM.CRC"
+
+/* one checksummed file */
+struct sument {
+  char sname[13];
+  long ssize;
+  char s32[C32LEN];
+  char s16[C16LEN];
+};
+
+struct sument ents[MAXF];
+int nents;
+
+/* USB files matching the wild card arguments */
+char wnames[MAXF*13];
+struct vnlist wlist;
+
+/* switches */
+int f_local, f_write, f_check;
+char mfname[FSLEN];
+
+/* drive for local files when checking, e.g. "B:" */
+char ldrive[FSLEN];
+
+/* show USB statistics at exit (-s) */
+int f_stats;
+
+/* dosw - process any switches on the command line.
+** Switches are preceded by "-".  If a numeric value
+** is given there should be no space, for example:
+** -p261 specifies port 261.
+*/
+dosw(argc, argv)
+int argc;
+char *argv[];
+{
+  int i;
+  char *s;
+
+  strcpy(mfname, MANIFEST);
+
+  /* process right to left */
+  for (i=argc-1; i>0; i--) {
+    s = argv[i];
+    if (*s++ == '-') {
+      /* have a switch! */
+      switch (*s) {
+      case 'C':
+        f_check = TRUE;
+        break;
+      case 'L':
+        f_local = TRUE;
+        break;
+      case 'W':
+        f_write = TRUE;
+        break;
+      case 'M':
+        strncpy(mfname, s+1, 12);
+        mfname[12] = NUL;
+        break;
+      case 'S':
+        f_stats = TRUE;
+        break;
+      case 'P':
+        ++s;
+        p_data = aotoi(s);
+        p_stat = p_data + 1;
+          break;
+      default:
+          printf("Invalid switch %c\n", *s);
+        break;
+      }
+    }
+  }
+}
+
+/* isfile - TRUE if argument s names a file (rather
+** than being a switch or a drive).
+*/
+int isfile(s)
+char *s;
+{
+  return (*s != '-') && (s[strlen(s)-1] != ':');
+}
+
+/* basename - return the part of a file spec after any
+** drive.
+*/
+char *basename(s)
+char *s;
+{
+  int i;
+
+  return ((i = index(s, ":")) == -1) ? s : s+i+1;
+}
+
+/* addent - add a file to the table. Returns a pointer to
+** the entry or 0 if the table is full.
+*/
+struct sument *addent(s)
+char *s;
+{
+  struct sument *e;
+
+  if (nents >= MAXF) {
+    printf("Too many files - only %d used\n", nents);
+    return 0;
+  }
+  e = &ents[nents++];
+  strncpy(e->sname, basename(s), 12);
+  e->sname[12] = NUL;
+  return e;
+}
+
+/* prent - show the checksums for an entry */
+prent(e)
+struct sument *e;
+{
+  static char lstr[12];
+
+  printf("%s %s %s %s\n", e->s32, e->s16, ltodec(e->ssize, lstr),
+    e->sname);
+}
+
+/* sumfiles - checksum the files named on the command
+** line.
+*/
+sumfiles(argc, argv)
+int argc;
+char *argv[];
+{
+  int i, nwild;
+  char *s;
+  struct sument *e;
+
+  nwild = 0;
+  for (i=1; i<argc; i++) {
+    s = argv[i];
+    if (!isfile(s))
+      continue;
+    if (!f_local && iswild(s)) {
+      ++nwild;
+      continue;
+    }
+    if ((e = addent(s)) == 0)
+      return;
+    if ((f_local ? lcrcf(s, -1L, &e->ssize, e->s32, e->s16) :
+        vcrcf(s, &e->ssize, e->s32, e->s16)) == -1) {
+      printf("Unable to read %s\n", s);
+      --nents;
+    }
+    else
+      prent(e);
+  }
+
+  /* one pass over the directory serves all patterns,
+  ** then the matching files are read.
+  */
+  if (nwild > 0) {
+    vnlinit(&wlist, wnames, MAXF*13);
+    vlswild(&wlist, argc, argv, 1);
+    for (i=0, s=wnames; i<wlist.nl_n; i++, s+=strlen(s)+1) {
+      /* never the manifest */
+      if (strcmp(s, mfname) == 0)
+        continue;
+      if ((e = addent(s)) == 0)
+        return;
+      if (vcrcf(e->sname, &e->ssize, e->s32, e->s16) == -1) {
+        printf("Unable to read %s\n", e->sname);
+        --nents;
+      }
+      else
+        prent(e);
+    }
+  }
+}
+
+/* anymatch - TRUE if name matches any file argument */
+int anymatch(argc, argv, name)
+int argc;
+char *argv[];
+char *name;
+{
+  int i;
+
+  for (i=1; i<argc; i++)
+    if (isfile(argv[i]) && wcmatch(argv[i], name))
+      return TRUE;
+  return FALSE;
+}
+
+/* putman - write the table to the manifest on the USB
+** drive. Returns -1 on error.
+*/
+int putman()
+{
+  struct vfile *f;
+  int i;
+  struct sument *e;
+  static char lstr[12];
+
+  if ((f = vfopen(mfname, "w")) == 0)
+    return -1;
+  for (i=0; i<nents; i++) {
+    e = &ents[i];
+    vfputs(e->s32, f);
+    vputc(' ', f);
+    vfputs(e->s16, f);
+    vputc(' ', f);
+    vfputs(ltodec(e->ssize, lstr), f);
+    vputc(' ', f);
+    vfputs(e->sname, f);
+    vfputs("\r\n", f);
+  }
+  return vfclose(f);
+}
+
+/* getfld - copy the next blank-delimited field of s to
+** d (at most n-1 bytes). Returns pointer past it.
+*/
+char *getfld(s, d, n)
+char *s, *d;
+int n;
+{
+  while (*s == ' ')
+    ++s;
+  while ((*s != NUL) && (*s != ' ') && (*s != '\r') && (*s != '\n')) {
+    if (--n > 0)
+      *d++ = *s;
+    ++s;
+  }
+  *d = NUL;
+  return s;
+}
+
+/* getman - read the whole manifest into the table. This
+** is done before any file is checked since only one file
+** may be open on the USB drive. Returns -1 on error.
+*/
+int getman()
+{
+  struct vfile *f;
+  struct sument *e;
+  char *s;
+  static char lstr[12];
+  /* not linebuff: vfgets() may refill its buffer part way
+  ** through a line, and the prompt is read into linebuff.
+  */
+  static char line[128];
+
+  if ((f = vfopen(mfname, "r")) == 0)
+    return -1;
+  while ((nents < MAXF) && (vfgets(line, 128, f) != 0)) {
+    e = &ents[nents];
+    s = getfld(line, e->s32, C32LEN);
+    s = getfld(s, e->s16, C16LEN);
+    s = getfld(s, lstr, 12);
+    e->ssize = dectol(lstr);
+    getfld(s, e->sname, 13);
+    if (e->sname[0] != NUL)
+      ++nents;
+  }
+  vfclose(f);
+  return 0;
+}
+
+/* chkfiles - check files against the manifest. Shows
+** the result for each file and the totals.
+*/
+chkfiles(argc, argv)
+int argc;
+char *argv[];
+{
+  int i, j, nargs, nok, nbad, nmiss, rc;
+  struct sument *e;
+  long len;
+  char c32[C32LEN], c16[C16LEN];
+  static char fname[FSLEN];
+
+  /* any file names given select which entries to check */
+  nargs = 0;
+  for (j=1; j<argc; j++)
+    if (isfile(argv[j]))
+      ++nargs;
+
+  nok = nbad = nmiss = 0;
+  for (i=0; i<nents; i++) {
+    e = &ents[i];
+    if ((nargs > 0) && !anymatch(argc, argv, e->sname))
+      continue;
+    if (f_local) {
+      strcpy(fname, ldrive);
+      strcat(fname, e->sname);
+      rc = lcrcf(fname, e->ssize, &len, c32, c16);
+    }
+    else
+      rc = vcrcf(e->sname, &len, c32, c16);
+
+    printf("%s ", e->sname);
+    if (rc == -1) {
+      printf("not found\n");
+      ++nmiss;
+    }
+    else if ((len != e->ssize) || (strcmp(c32, e->s32) != 0) ||
+             (strcmp(c16, e->s16) != 0)) {
+      printf("FAILED\n");
+      ++nbad;
+    }
+    else {
+      printf("OK\n");
+      ++nok;
+    }
+  }
+  printf("\n%d OK, %d failed, %d not found\n", nok, nbad, nmiss);
+}
+
+main(argc,argv)
+int argc;
+char *argv[];
+{
+  int i, nfiles, userport;
+
+  printf("VSUM v%s, ", VERSION);
+
+  /* Set default values */
+  p_data = VDATA;
+  p_stat = VSTAT;
+
+  /* set globals 'os' and 'osver' */
+  getosver();
+
+	/* check if user has a file specifying the port. For
+	** HDOS we can provide the location of this program executable
+	** but for CP/M we can only suggest looking on A:
+	*/
+#ifdef HDOS
+	userport = chkport("SY0:");
+#else
+	userport = chkport("A:");
+#endif
+
+  /* process any switches and set defaults */
+  dosw(argc, argv);
+
+  printf("using %s port: [%o]\n", (userport ? "user-specified" : "default"), p_data);
+
+  /* a bare drive gives where local copies are checked */
+  ldrive[0] = NUL;
+  nfiles = 0;
+  for (i=1; i<argc; i++)
+    if (isfile(argv[i]))
+      ++nfiles;
+    else if (*argv[i] != '-')
+      strncpy(ldrive, argv[i], FSLEN-1);
+
+  if (!f_check && (nfiles == 0)) {
+    printf("Usage: VSUM file {file} ... <-l> <-w> <-mname> <-pxxx>\n");
+    printf("       VSUM -c {file} ... {d:} <-l> <-mname> <-pxxx>\n");
+    printf("\tfile may use * and ? wild cards (USB files)\n");
+    printf("\t-l local files, -w write manifest, -c check manifest\n");
+    printf("\tname is the manifest file (default %s)\n", MANIFEST);
+    printf("\t-s to show USB statistics at exit\n");
+    printf("\txxx is USB optional port in octal (default is %o)\n", VDATA);
+  }
+  else if (vinit() == -1) {
+    printf("Error initializing VDIP-1 device!\n");
+  }
+  else if (vfind_disk() == -1) {
+    printf("No flash drive found!\n");
+  }
+  else {
+    crcini();
+    if (f_check) {
+      if (getman() == -1)
+        printf("Unable to read %s\n", mfname);
+      else
+        chkfiles(argc, argv);
+    }
+    else {
+      sumfiles(argc, argv);
+      if (f_write && (nents > 0)) {
+        if (putman() == -1)
+          printf("Unable to write %s\n", mfname);
+        else
+          printf("\n%d file%s written to %s\n", nents,
+            (nents == 1) ? "" : "s", mfname);
+      }
+    }
+  }
+  if (f_stats)
+    vstats();
+}
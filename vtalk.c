@@ -1,9 +1,15 @@
 /********************************************************
 ** vtalk - Version 4.1 for CP/M3 and HDOS
 **
-** USAGE: vtalk {-pxxx}
+** USAGE: vtalk {-fscript} {-lname} {-rnn} {-pxxx}
 **
-** xxx is optional octal base port (default is 0331)
+**    switches:
+**      -fscript to send the Vinculum commands in file
+**         'script' instead of talking interactively
+**      -lname to log the script replies to 'name' (the
+**         default is VTALK.LOG)
+**      -rnn to run the script nn times (default 1)
+**      -pxxx to specify octal port (default is 0261)
 **
 ** HDOS operation requires H89 or H8 with H8-4 serial card.
 ** The software will check for this and abort with a message 
@@ -19,13 +25,33 @@
 **
 ** To exit type Ctrl-C.
 **
+** In script mode each line of the script is sent as a
+** command as soon as the reply to the one before has ended
+** with the prompt or an error message. A line may start
+** with "*nn " to send that command nn times; lines starting
+** with ';' are copied to the log as comments and blank
+** lines are skipped. For every command the log records the
+** time it was sent, each line of the reply, the time to the
+** first byte of the reply and the time in all, e.g.
+**
+**        1234 > OPW TEST.DAT
+**               D:\>
+**             = 8 ms to first byte, 10 ms in all
+**
+** Times are in ms from the start of the run, at 2 ms
+** resolution under HDOS and CP/M 2.2 but only to the second
+** under CP/M 3 and MP/M. A command with no reply for
+** MAXWAIT seconds is logged as a timeout and the script
+** goes on. Commands that return file data (RDF) are logged
+** as text, and there is no way to send binary data (WRF).
+**
 ** Compiled with Software Toolworks C 3.1
 **
 **  External routines to resolve at link time:
 **    printf, inp, outp
 **
 **  Suggested link statement:
-**  L80 vtalk,vinc,vutil,pio,fprintf,scanf,flibrary/s,stdlib/s,clibrary/s,vtalk/n/e
+**  L80 vtalk,vutil,pio,fprintf,seek,flibrary/s,stdlib/s,clibrary/s,vtalk/n/e
 **
 **  This code uses ifdef to choose between HDOS and CP/M
 **  I/O calls. if HDOS is defined then the HDOS code will
@@ -60,6 +86,14 @@
 **
 ** 12 April 2025 - simplified version and port reporting to single line.
 **
+** 18 October 2026 - added script mode (-f, -l, -r) to replay
+** a file of commands and log the replies and their latency.
+**
+** 18 October 2026 - VDIP output now goes to the console
+** through a ring buffer, with the VDIP FIFO read in bulk
+** whenever it has data, so a long listing no longer holds
+** the VDIP up while each character waits for the console.
+**
 ********************************************************/
 #include "fprintf.h"
 
@@ -69,6 +103,20 @@
 #include "vinc.h"
 
 #define CTLC  3   /* control-C to exit loop */
+#define RINGSZ  2048    /* console ring, a power of 2 */
+#define FSLEN   20
+#define LINESZ  128     /* longest script or reply line */
+#define MAXWAIT 5       /* seconds to wait for a reply */
+#define LOGFILE "VTALK.LOG"
+#define CPMEOF  0x1A    /* CP/M text end-of-file (^Z) */
+
+/* script mode */
+char scrname[FSLEN];    /* -f script file, empty if none */
+char logname[FSLEN];    /* -l log file */
+int nrepeat;            /* -r times to run the script */
+int logch;              /* log file channel */
+
+long msec();
 
 #ifndef HDOS
 /************************************
@@ -103,6 +151,15 @@ char c;
   bdos(6, c);
 }
 
+/* cready - TRUE if the console can take a character.
+** CP/M has no console output status, so this is always
+** TRUE and conout() waits for at most one character.
+*/
+int cready()
+{
+  return TRUE;
+}
+
 /* conin - input a character from the console using CP/M
 ** Direct Console I/O BDOS call (function 6).
 ** Returns the character or NUL if no data avail.
@@ -180,6 +237,12 @@ char c;
   outp(CONSOLE,c);
 }
 
+/* cready - TRUE if the UART can take a character */
+int cready()
+{
+  return ((inp(CONSOLE+5) & 0x20) != 0);
+}
+
 /* conin - return a character directly from the
 ** console port, return NUL if none available
 */
@@ -202,6 +265,41 @@ int conin()
 */
 #endif  
 
+/* ring buffer between VDIP input and console output.
+** The VDIP FIFO can be emptied much faster than a serial
+** console can print, so output is held here rather than
+** leaving the loop waiting on the console for every
+** character. When the ring is full the VDIP is simply not
+** read until there is room again.
+*/
+char ring[RINGSZ];
+int rhead;      /* next free slot */
+int rtail;      /* next character for the console */
+
+/* rput - add a character to the ring, there must be room */
+rput(c)
+char c;
+{
+  ring[rhead] = c;
+  rhead = (rhead + 1) & (RINGSZ-1);
+}
+
+/* rget - take the oldest character from the ring */
+int rget()
+{
+  int c;
+
+  c = ring[rtail];
+  rtail = (rtail + 1) & (RINGSZ-1);
+  return c;
+}
+
+/* rfree - room left in the ring */
+int rfree()
+{
+  return (RINGSZ-1) - ((rhead - rtail) & (RINGSZ-1));
+}
+
 /* out_vdip - send a character to the VDIP-1 via the
 ** specified port
 */
@@ -229,6 +327,197 @@ int in_vdip()
     return -1;
 }
 
+/* msec - ms elapsed since ticks() was t */
+long msec(t)
+long t;
+{
+  return (ticks() - t) * 1000L / tickhz();
+}
+
+/* sendln - send a command line and its CR to the VDIP-1 */
+sendln(s)
+char *s;
+{
+  while (*s)
+    out_vdip(*s++);
+  out_vdip('\r');
+}
+
+/* isend - TRUE if reply line s ends the reply to a command.
+** The E command is answered by its own echo.
+*/
+int isend(s, echo)
+char *s;
+int echo;
+{
+  int i;
+  /* VNC1L replies that end a command instead of the prompt */
+  static char *vnerrs[] = {
+    "Bad Command", "Command Failed", "Disk Full", "Invalid",
+    "Read Only", "File Open", "Dir Not Empty", "Filename Invalid",
+    "No Disk", "No Upgrade", 0
+  };
+
+  if ((strcmp(s, PROMPT) == 0) || (echo && (strcmp(s, "E") == 0)) ||
+      (echo && (strcmp(s, "e") == 0)))
+    return TRUE;
+  for (i=0; vnerrs[i] != 0; i++)
+    if (strcmp(s, vnerrs[i]) == 0)
+      return TRUE;
+  return FALSE;
+}
+
+/* getresp - read the reply to a command a line at a time,
+** copying each line to the log. *tfirst is set to the time
+** of the first byte in ms since t0. Returns 0 once the
+** reply has ended or -1 if the VDIP-1 went quiet for
+** MAXWAIT seconds.
+*/
+int getresp(echo, t0, tfirst)
+int echo;
+long t0, *tfirst;
+{
+  int c, n, rc;
+  static char line[LINESZ];
+
+  *tfirst = -1L;
+  n = 0;
+  rc = 1;
+  while (rc == 1) {
+    timer(1, MAXWAIT);
+    while (((c = in_vdip()) == -1) && timer(0, 0))
+      ;
+    if (c == -1)
+      rc = -1;
+    else {
+      if (*tfirst == -1L)
+        *tfirst = msec(t0);
+      if (c != '\r') {
+        if (n < LINESZ-1)
+          line[n++] = c;
+      }
+      else {
+        line[n] = NUL;
+        n = 0;
+        fprintf(logch, "               %s\n", line);
+        if (isend(line, echo))
+          rc = 0;
+      }
+    }
+  }
+  if (n > 0) {
+    /* the start of a line that never ended */
+    line[n] = NUL;
+    fprintf(logch, "               %s\n", line);
+  }
+  return rc;
+}
+
+/* getl - read a line of the script into s, without the
+** line ending. Returns its length or -1 at end of file.
+*/
+int getl(chan, s, n)
+int chan, n;
+char *s;
+{
+  int c, i;
+
+  i = 0;
+  while (((c = getc(chan)) != -1) && (c != CPMEOF) && (c != '\n'))
+    if ((c != '\r') && (i < n-1))
+      s[i++] = c;
+  s[i] = NUL;
+  return ((i == 0) && (c != '\n')) ? -1 : i;
+}
+
+/* runscript - send each command in the script nrepeat
+** times over, logging the replies and their latency.
+** Ctrl-C on the console stops the run. Returns -1 if the
+** script or log could not be opened.
+*/
+int runscript()
+{
+  int sch, pass, rep, n, echo, rc, ncmds, ntmo, done;
+  long t0, tsent, tfirst, tdone;
+  char *s;
+  static char cmd[LINESZ];
+  static char ms1[12], ms2[12], ms3[12];
+
+  if ((logch = fopen(logname, "w")) == 0) {
+    printf("Unable to create log file %s\n", logname);
+    return -1;
+  }
+
+  /* get the VDIP-1 to a prompt before timing anything */
+  sendln("");
+  fprintf(logch, "; VTALK v%s script %s\n", VERSION, scrname);
+  getresp(FALSE, ticks(), &tfirst);
+
+  ncmds = ntmo = 0;
+  done = FALSE;
+  t0 = ticks();
+  for (pass=1; !done && (pass <= nrepeat); pass++) {
+    if ((sch = fopen(scrname, "r")) == 0) {
+      printf("Unable to open script %s\n", scrname);
+      fclose(logch);
+      return -1;
+    }
+    fprintf(logch, "; pass %d\n", pass);
+    while (!done && (getl(sch, cmd, LINESZ) != -1)) {
+      s = cmd;
+      if (*s == ';') {
+        fprintf(logch, "%s\n", s);
+        continue;
+      }
+      if (*s == NUL)
+        continue;
+      n = 1;
+      if (*s == '*') {
+        /* "*nn command" repeats the command */
+        n = (int) dectol(++s);
+        while (*s && (*s != ' '))
+          ++s;
+        while (*s == ' ')
+          ++s;
+      }
+      echo = (strcmp(s, "E") == 0) || (strcmp(s, "e") == 0);
+      for (rep=0; !done && (rep < n); rep++) {
+        if (conin() == CTLC) {
+          fprintf(logch, "; stopped by Ctrl-C\n");
+          done = TRUE;
+          break;
+        }
+        tsent = msec(t0);
+        fprintf(logch, "%12s > %s\n", ltodec(tsent, ms1), s);
+        sendln(s);
+        rc = getresp(echo, t0, &tfirst);
+        tdone = msec(t0) - tsent;
+        ++ncmds;
+        if (rc == -1) {
+          ++ntmo;
+          fprintf(logch, "             = timeout, no reply for %d s\n", MAXWAIT);
+          printf("  timeout  %s\n", s);
+        }
+        else {
+          ltodec(tfirst - tsent, ms2);
+          ltodec(tdone, ms3);
+          fprintf(logch, "             = %s ms to first byte, %s ms in all\n",
+            ms2, ms3);
+          printf("%6s ms  %s\n", ms3, s);
+        }
+      }
+    }
+    fclose(sch);
+  }
+  fclose(logch);
+
+  printf("\n%d commands in %s ms", ncmds, ltodec(msec(t0), ms1));
+  if (ntmo > 0)
+    printf(", %d timed out", ntmo);
+  printf("\nReplies logged to %s\n", logname);
+  return 0;
+}
+
 /* dosw - process '-' switches and arguments
 */
 dosw(argc, argv)
@@ -249,6 +538,16 @@ char *argv[];
         p_data = aotoi(s);
         p_stat = p_data + 1;
           break;
+      case 'F':
+        strncpy(scrname, ++s, FSLEN-1);
+        break;
+      case 'L':
+        strncpy(logname, ++s, FSLEN-1);
+        break;
+      case 'R':
+        if ((nrepeat = (int) dectol(++s)) < 1)
+          nrepeat = 1;
+        break;
       default:
           printf("Invalid switch %c\n", *s);
         break;
@@ -269,6 +568,14 @@ char *argv[];
   p_data = VDATA;
   p_stat = VSTAT;
 
+  /* defaults for script mode */
+  scrname[0] = NUL;
+  strcpy(logname, LOGFILE);
+  nrepeat = 1;
+
+  /* timer() needs to know the OS */
+  getosver();
+
 	/* check if user has a file specifying the port. For
 	** HDOS we can provide the location of this program executable
 	** but for CP/M we can only suggest looking on A:
@@ -284,12 +591,19 @@ char *argv[];
 
   /* print welcome */
   printf("using %s port: [%o]\n", (userport ? "user-specified" : "default"), p_data);
-  printf("\nEnter Vinculum commands, Ctrl-C to exit\n\n");
+  if (scrname[0] == NUL)
+    printf("\nEnter Vinculum commands, Ctrl-C to exit\n\n");
+  else
+    printf("\nRunning script %s, Ctrl-C to stop\n\n", scrname);
 
   
   /* perform any console initialization */
   if (copen() == -1)
     printf("Unable to open console - 8250 UART not detected.\n");
+  else if (scrname[0] != NUL) {
+    runscript();
+    cclose();
+  }
   else {
     done = FALSE;
     cr_pending = FALSE;
@@ -298,14 +612,18 @@ char *argv[];
     out_vdip('\r');
   
     /* this loop repeatedly polls for input on the
-    ** console, echos that to the VDIP, then polls
-    ** the VDIP and echos that to the console. Ctrl-C
-    ** on the console exits the loop.
+    ** console and sends that to the VDIP, empties the
+    ** VDIP FIFO into the ring and then gives the console
+    ** one character from the ring if it can take it.
+    ** Ctrl-C on the console exits the loop.
     */
     while(!done) {
 
-      /* process console input, if any */
-      if ((c=conin()) != 0) {
+      /* process console input, if any. the echo goes
+      ** through the ring to keep its place among the
+      ** VDIP output.
+      */
+      if ((rfree() >= 2) && ((c=conin()) != 0)) {
         /* control-C is escape character */
         if (c == CTLC)
           done = TRUE;
@@ -313,32 +631,38 @@ char *argv[];
           /* send to VDIP */
           out_vdip(c);
           /* echo to console; add LF to CR */
-          conout(c);
+          rput(c);
           if (c == '\r') {
-            conout('\n');
+            rput('\n');
             /* don't care about pending CR */
             cr_pending = FALSE;
           }
         }
       }
     
-      /* process VDIP input, if any.  the VDIP has an annoying
-      ** habit of sending CR after every output, including
-      ** the prompt.  here we supress that CR
+      /* process VDIP input, as much as there is room for.
+      ** the VDIP has an annoying habit of sending CR after
+      ** every output, including the prompt.  here we
+      ** supress that CR
       */
-      if ((c=in_vdip()) != -1) {
+      while (((inp(p_stat) & VRXF) != 0) && (rfree() >= 3)) {
+        c = inp(p_data);
         /* check if CR is pending output */
         if (cr_pending) {
-          conout('\r');
-          conout('\n');
+          rput('\r');
+          rput('\n');
           cr_pending = FALSE;
         }
         if (c == '\r')
           /* if CR just mark as pending */
           cr_pending = TRUE;
         else
-          conout(c);
+          rput(c);
       }
+
+      /* and on to the console if it is ready */
+      if ((rhead != rtail) && cready())
+        conout(rget());
     }
     /* Ctrl-c has been hit. print a new line, reset any console
 	** changes and exit
@@ -0,0 +1,257 @@
+/********************************************************
+** vtype - Version 4.3 for CP/M and HDOS
+**
+** This program displays a text file on the USB flash drive
+** on the console, or prints it, without first copying it to
+** a local disk.
+**
+** Usage: vtype file {-c} {-l} {-pxxx}
+**
+**    'file' is the name of a text file on the USB drive.
+**
+**    switches:
+**      -c continuous output (don't pause after each screen)
+**      -l send the output to the printer (LST: or LP:)
+**      -s to show USB transfer statistics at exit
+**      -pxxx to specify octal port (default is 0261)
+**
+** The file is read through the vfile stream library, so it
+** is fetched from the device in large chunks rather than a
+** line at a time. Either CR-LF or LF line endings are
+** accepted, and a ^Z ends the file as it would under CP/M.
+** Output to the console pauses after each screen; press a
+** key (RETURN under HDOS) to continue, or ^C or Q to quit.
+**
+** Compiled with Software Toolworks C/80 V. 3.1 with support for
+** floats and longs.  Typical link statement:
+**
+** L80 vtype,vfile,vinc,vutil,pio,fprintf,seek,flibrary/s,stdlib/s,clibrary/s,vtype/n/e
+**
+** Our convention is to save all files with CP/M style
+** line endings (CR-LF). The HDOS version of C/80 is picky
+** and wants to see just LF (which is the HDOS standard line ending,
+** therefore the CR characters must be stripped out before compilation.
+** A separate STRIP.C program provides this capability.
+**
+** 18 October 2026
+**
+********************************************************/
+#include "fprintf.h"
+
+/* ensure globals live here */
+#define EXTERN
+#include "vutil.h"
+#include "vinc.h"
+#include "vfile.h"
+
+#define PAGELEN 23      /* lines per screen before pausing */
+#define CPMEOF  0x1A
+#define CTLC    0x03
+
+/* switches */
+int f_cont, f_lst;
+
+/* lines shown since the last pause */
+int nlines;
+
+#ifdef HDOS
+/* printer channel */
+int lpchan;
+#endif
+
+/* show USB statistics at exit (-s) */
+int f_stats;
+
+/* dosw - process any switches on the command line.
+** Switches are preceded by "-".  If a numeric value
+** is given there should be no space, for example:
+** -p261 specifies port 261.  Switches must be to
+** the right of the file name on the command line.
+** Since argv[1] is required (file name)
+** this routine only looks at argv[2] and above.
+*/
+dosw(argc, argv)
+int argc;
+char *argv[];
+{
+  int i;
+  char *s;
+
+  /* process right to left */
+  for (i=argc-1; i>1; i--) {
+    s = argv[i];
+    if (*s++ == '-') {
+      /* have a switch! */
+      switch (*s) {
+      case 'C':
+        f_cont = TRUE;
+        break;
+      case 'L':
+        f_lst = TRUE;
+        break;
+      case 'S':
+        f_stats = TRUE;
+        break;
+      case 'P':
+        ++s;
+        p_data = aotoi(s);
+        p_stat = p_data + 1;
+          break;
+      default:
+          printf("Invalid switch %c\n", *s);
+        break;
+      }
+    }
+  }
+}
+
+/* getkey - wait for a key at the console */
+int getkey()
+{
+#ifdef HDOS
+  return getchar();
+#else
+  int c;
+
+  while ((c = bdos(6, 0xFF)) == 0)
+    ;
+  return c;
+#endif
+}
+
+/* more - pause at the end of a screen. Returns TRUE if
+** the user wants to quit.
+*/
+int more()
+{
+  int c;
+
+  printf("-- More --");
+  c = toupper(getkey());
+  printf("\r          \r");
+  nlines = 0;
+  return (c == CTLC) || (c == 'Q');
+}
+
+/* lstout - send a character to the printer */
+lstout(c)
+char c;
+{
+#ifdef HDOS
+  putc(c, lpchan);
+#else
+  bdos(5, c);
+#endif
+}
+
+/* vtout - send a character of the file to its
+** destination. Line endings in the file are reduced to
+** '\n' before they get here. Returns TRUE if the user
+** wants to quit.
+*/
+int vtout(c)
+char c;
+{
+  if (f_lst) {
+#ifndef HDOS
+    if (c == '\n')
+      lstout('\r');
+#endif
+    lstout(c);
+    return FALSE;
+  }
+  putchar(c);
+  if ((c == '\n') && !f_cont && (++nlines >= PAGELEN))
+    return more();
+  return FALSE;
+}
+
+/* vtype - display the file. Returns -1 if the file
+** could not be opened.
+*/
+int vtype(name)
+char *name;
+{
+  struct vfile *f;
+  int c;
+
+  if ((f = vfopen(name, "r")) == 0)
+    return -1;
+
+  while (((c = vgetc(f)) != VFEOF) && (c != CPMEOF)) {
+    /* treat CR-LF and lone LF alike */
+    if (c == '\r')
+      continue;
+    if (vtout(c))
+      break;
+#ifndef HDOS
+    /* check for ^C */
+    if (c == '\n')
+      CtlCk();
+#endif
+  }
+  vfclose(f);
+  return 0;
+}
+
+main(argc,argv)
+int argc;
+char *argv[];
+{
+  int userport;
+
+  printf("VTYPE v%s, ", VERSION);
+
+  /* Set default values */
+  p_data = VDATA;
+  p_stat = VSTAT;
+
+  /* set globals 'os' and 'osver' to direct use of time and
+  ** date functions
+  */
+  getosver();
+
+	/* check if user has a file specifying the port. For
+	** HDOS we can provide the location of this program executable
+	** but for CP/M we can only suggest looking on A:
+	*/
+#ifdef HDOS
+	userport = chkport("SY0:");
+#else
+	userport = chkport("A:");
+#endif
+
+  /* process any switches and set defaults */
+  dosw(argc, argv);
+
+  printf("using %s port: [%o]\n", (userport ? "user-specified" : "default"), p_data);
+
+  if (argc < 2) {
+    printf("Usage: VTYPE usbfile <-c> <-l> <-pxxx>\n");
+    printf("\t-c for continuous output (no paging)\n");
+    printf("\t-l to send output to the printer\n");
+    printf("\t-s to show USB statistics at exit\n");
+    printf("\txxx is USB optional port in octal (default is %o)\n", VDATA);
+  }
+  else if (vinit() == -1) {
+    printf("Error initializing VDIP-1 device!\n");
+  }
+  else if (vfind_disk() == -1) {
+    printf("No flash drive found!\n");
+  }
+#ifdef HDOS
+  else if (f_lst && ((lpchan = fopen("LP:", "w")) == 0)) {
+    printf("Unable to open LP:\n");
+  }
+#endif
+  else {
+    if (vtype(argv[1]) == -1)
+      printf("Unable to open %s\n", argv[1]);
+#ifdef HDOS
+    if (f_lst)
+      fclose(lpchan);
+#endif
+  }
+  if (f_stats)
+    vstats();
+}
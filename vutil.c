@@ -22,6 +22,16 @@
 **
 **  24 October 2024 - added chkport()
 **
+**  18 October 2026 - added dectol() and ltodec()
+**
+**  18 October 2026 - added wcmatch() and iswild()
+**
+**  18 October 2026 - added lseekl()
+**
+**  18 October 2026 - added vnlinit() and vnladd()
+**
+**  18 October 2026 - added ltotenth()
+**
 ********************************************************/
 #include "fprintf.h"
 #include "scanf.h"
@@ -80,6 +90,10 @@ int getosver()
 int bdoshl(c,de)
   int c, de;
 {
+#ifdef HOST
+  /* host build - see host/c80.c */
+  return bdos(c, de);
+#else
 #asm
         POP     H
         POP     D
@@ -89,6 +103,7 @@ int bdoshl(c,de)
         PUSH    H
         CALL    5
 #endasm
+#endif
 }
 
 /********************************************************
@@ -203,7 +218,8 @@ unsigned i;
 ** Create a string containing the representation of a 
 ** long with commas every third position.  len is the
 ** allocated size of the string s. caution: len must 
-** be declared big enough to hold any long.
+** be declared big enough to hold any long. The value is
+** taken as unsigned (file sizes up to 4G).
 **
 ********************************************************/
 int commafmt(n, s, len)
@@ -213,12 +229,20 @@ int len;
 {
   char *p;
   int i;
+  long q10;
 
   /* work backward from end of string */
   p = s + len - 1;
   *p = 0;
 
   i = 0;
+  if (n < 0L) {
+    /* 2G and up: one unsigned divide by 10 first */
+    q10 = ((n >> 1) & 0x7FFFFFFFL) / 5L;
+    *--p = '0' + (int) (n - q10 * 10L);
+    n = q10;
+    i++;
+  }
   do {
     if(((i % 3) == 0) && (i != 0))
       *--p = ',';
@@ -251,6 +275,137 @@ char s[];
 }
 
 
+/********************************************************
+**
+** dectol
+**
+** Convert a decimal string to a long. Leading blanks
+** are skipped; conversion stops at the first non-digit.
+** Values from 2G to 4G wrap to negative, i.e. the result
+** holds the unsigned 32-bit value.
+**
+********************************************************/
+long dectol(s)
+char *s;
+{
+  long n;
+
+  n = 0L;
+  while (*s == ' ')
+    ++s;
+  for ( ; (*s >= '0') && (*s <= '9'); ++s)
+    n = 10L * n + (*s - '0');
+  return n;
+}
+
+/********************************************************
+**
+** ltodec
+**
+** Convert a long to its decimal string representation
+** in s (which must hold at least 10 characters plus the
+** terminating NUL). The value is taken as unsigned, so
+** file sizes and offsets up to 4G are handled. Returns s.
+**
+********************************************************/
+char *ltodec(n, s)
+long n;
+char *s;
+{
+  char *p, *q;
+  char c;
+  long q10;
+
+  p = s;
+  if (n < 0L) {
+    /* 2G and up: do one unsigned divide by 10 (halve,
+    ** clear the sign, divide by 5) to bring n in range
+    */
+    q10 = ((n >> 1) & 0x7FFFFFFFL) / 5L;
+    *p++ = '0' + (int) (n - q10 * 10L);
+    n = q10;
+  }
+  do {
+    *p++ = '0' + (n % 10);
+    n /= 10;
+  } while (n != 0);
+  *p = NUL;
+
+  /* digits were generated backwards - reverse them */
+  for (q = s, --p; q < p; ++q, --p) {
+    c = *q;
+    *q = *p;
+    *p = c;
+  }
+  return s;
+}
+
+/********************************************************
+**
+** ltotenth
+**
+** Format v, a count of tenths, as a decimal number with
+** one place in s (e.g. 5 as "0.5", 123 as "12.3"). s must
+** hold at least 12 characters. Returns s.
+**
+********************************************************/
+char *ltotenth(v, s)
+long v;
+char *s;
+{
+  int l;
+
+  ltodec(v, s);
+  l = strlen(s);
+  if (l == 1) {
+    s[2] = s[0];
+    s[0] = '0';
+    l = 2;
+  }
+  else
+    s[l] = s[l-1];
+  s[l-1] = '.';
+  s[l+1] = NUL;
+  return s;
+}
+
+/********************************************************
+**
+** lseekl
+**
+** Position local file chan at a byte offset. C/80 seek()
+** takes an int offset, so seek by 512-byte blocks (origin
+** 3) and then by bytes from there (origin 1). The byte
+** before offset is read to be sure the file reaches that
+** far.
+**
+** Returns:
+**    0 on Success
+**    -1 if the file ends before offset, in which case
+**       chan is left at the start of the file
+**
+********************************************************/
+int lseekl(chan, offset)
+int chan;
+long offset;
+{
+  char c;
+  long p;
+
+  if (offset > 0L) {
+    p = offset - 1L;
+    seek(chan, (int) (p / 512), 3);
+    seek(chan, (int) (p % 512), 1);
+    if (read(chan, &c, 1) != 1) {
+      seek(chan, 0, 0);
+      return -1;
+    }
+  }
+  seek(chan, (int) (offset / 512), 3);
+  seek(chan, (int) (offset % 512), 1);
+  return 0;
+}
+
 /********************************************************
 **
 ** strrchr
@@ -328,6 +483,122 @@ char *s;
 
 }
 
+/********************************************************
+**
+** wcmatch
+**
+** Match string s against a file name pattern p in which
+** '*' matches any run of characters and '?' any single
+** character.  Case is ignored.  A name without an
+** extension also matches as "NAME." so that "*.*" selects
+** every file, as it does in CP/M and HDOS.
+**
+** Returns TRUE on a match.
+**
+********************************************************/
+int wcmatch(p, s)
+char *p, *s;
+{
+  static char dotted[14];
+
+  if (wcmat1(p, s))
+    return TRUE;
+  if ((index(s, ".") != -1) || (strlen(s) > 12))
+    return FALSE;
+  strcpy(dotted, s);
+  strcat(dotted, ".");
+  return wcmat1(p, dotted);
+}
+
+/* wcmat1 - one pass of wcmatch(). On a mismatch after a
+** '*' the star is retried one character further along.
+*/
+int wcmat1(p, s)
+char *p, *s;
+{
+  char *sp, *ss;
+
+  sp = 0;
+  ss = s;
+  while (*s != NUL) {
+    if (*p == '*') {
+      sp = ++p;
+      ss = s;
+    }
+    else if ((*p == '?') || (toupper(*p) == toupper(*s))) {
+      ++p;
+      ++s;
+    }
+    else if (sp != 0) {
+      p = sp;
+      s = ++ss;
+    }
+    else
+      return FALSE;
+  }
+  while (*p == '*')
+    ++p;
+  return (*p == NUL);
+}
+
+/********************************************************
+**
+** iswild
+**
+** Returns TRUE if the string contains wild cards.
+**
+********************************************************/
+int iswild(s)
+char *s;
+{
+  return (index(s, "*") != -1) || (index(s, "?") != -1);
+}
+
+/********************************************************
+**
+** vnlinit
+**
+** Set up nl as an empty list of names kept in buf, which
+** holds size bytes.
+**
+********************************************************/
+int vnlinit(nl, buf, size)
+struct vnlist *nl;
+char *buf;
+int size;
+{
+  nl->nl_buf = buf;
+  nl->nl_size = size;
+  nl->nl_len = 0;
+  nl->nl_n = 0;
+}
+
+/********************************************************
+**
+** vnladd
+**
+** Add the name s to the end of the list nl.
+**
+** Returns:
+**    0: Normal
+**    -1: no room (the list is unchanged)
+**
+********************************************************/
+int vnladd(nl, s)
+struct vnlist *nl;
+char *s;
+{
+  int l;
+
+  l = strlen(s) + 1;
+  if (nl->nl_len + l > nl->nl_size)
+    return -1;
+  strcpy(nl->nl_buf + nl->nl_len, s);
+  nl->nl_len += l;
+  ++nl->nl_n;
+  return 0;
+}
+
 /********************************************************
 **
 ** isprint
@@ -388,6 +659,45 @@ int is_leap(year) {
   return (((year%4==0)&&((year%100)!=0)) || ((year%400)==0));
 }
 
+/********************************************************
+**
+** secclk
+**
+** returns a pointer to the one-second (BCD) tick counter
+** kept by CP/M 3 and MP/M.
+**
+********************************************************/
+char *secclk()
+{
+  int *tmp;
+  /* CP/M 3 and MP/M use BDOS calls to find system clock */
+  struct scbstruct scbs;
+  /* initalized to NULL to force it to be set up when
+  ** first accessed
+  */
+  static char *secp = 0;
+
+  if (secp == 0) {
+    /* The first time this is called we need to set
+    ** up a pointer to the one-second tick counter.
+    ** CP/M 3 and MP/M use different techniques
+    ** for finding this pointer
+    */
+    if (os==OSMPM) {
+      /* MP/M */
+      tmp = (int *)bdoshl(GETSDA, 0);
+      tmp = tmp[126]; /* offset 252: XDOS internal data */
+      secp = (char *)tmp + 4;
+    } else {
+      /* CP/M 3 */
+      scbs.offset = SOSCB;  /* offset for SCB address (undocumented) */
+      scbs.set  = 0;    /* do a "get" not a "set" */
+      secp = (char *)bdoshl(GETSCB, &scbs) + SOSEC;
+    }
+  }
+  return secp;
+}
+
 /********************************************************
 **
 ** timer
@@ -407,19 +717,13 @@ int timer(init, t)
 int init, t;
 {
   int rc;
-  int *tmp;
   
   /* statics to retain value across multiple calls */
   /* For CP/M2 and HDOS we use a pointer to 2-ms clock */
   static unsigned *Ticptr = TICCNT;
   static unsigned timeout;  
-  /* CP/M 3 and MP/M use BDOS calls to find system clock */
-  struct scbstruct scbs;
-  /* pointer to the one-second tick counter in CP/M 3.
-  ** initalized to NULL to force it to be set up when
-  ** timer is first accessed
-  */
-  static char *secp = 0;
+  /* pointer to the one-second tick counter in CP/M 3 */
+  static char *secp;
   static int snapshot;
   static int countdown;
 
@@ -427,25 +731,7 @@ int init, t;
   if (init) {
     /* CP/M 3 and MP/M use one-second system clock */
     if ((os==OSMPM) || ((os==OSCPM) && (osver>=0x30))) {
-      if (secp == 0) {
-        /* The first time this is called we need to set
-        ** up a pointer to the one-second tick counter.
-        ** We'll use this to test for timeouts when reading 
-        ** data. CP/M 3 and MP/M use different techniques
-        ** for finding this pointer
-        */
-        if (os==OSMPM) {
-          /* MP/M */
-          tmp = (int *)bdoshl(GETSDA, 0);
-          tmp = tmp[126]; /* offset 252: XDOS internal data */
-          secp = (char *)tmp + 4;
-        } else {
-          /* CP/M 3 */
-          scbs.offset = SOSCB;  /* offset for SCB address (undocumented) */
-          scbs.set  = 0;    /* do a "get" not a "set" */
-          secp = (char *)bdoshl(GETSCB, &scbs) + SOSEC;
-        }
-      }
+      secp = secclk();
     
       /* snapshot the time in seconds and start the coundown */
       snapshot = *secp;
@@ -488,6 +774,58 @@ int init, t;
   return rc;
 }
 
+/********************************************************
+**
+** ticks
+**
+** returns a running count of clock ticks, for measuring
+** elapsed time rather than timeouts. The count is kept in
+** a long so it does not wrap like the clocks it is read
+** from, but ticks() must be called at least once a minute
+** for this to work. tickhz() gives the ticks per second.
+**
+********************************************************/
+long ticks()
+{
+  static unsigned *Ticptr = TICCNT;
+  static int first = TRUE;
+  static unsigned last;
+  static long total;
+  unsigned now, d;
+
+  if ((os==OSMPM) || ((os==OSCPM) && (osver>=0x30))) {
+    /* one-second clock counts 0..59 in BCD */
+    now = btod(*secclk());
+    if (first)
+      last = now;
+    d = (now + 60 - last) % 60;
+  }
+  else {
+    now = *Ticptr;
+    if (first)
+      last = now;
+    d = now - last;
+  }
+  first = FALSE;
+  last = now;
+  total += d;
+  return total;
+}
+
+/********************************************************
+**
+** tickhz
+**
+** number of ticks() per second
+**
+********************************************************/
+int tickhz()
+{
+  if ((os==OSMPM) || ((os==OSCPM) && (osver>=0x30)))
+    return 1;
+  return 500;
+}
+
 
 /********************************************************
 **
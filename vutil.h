@@ -57,7 +57,12 @@ static char *stime = S_TIME;
 /* key time/date locations in CP/M */
 
 /* pointer to 2ms ISR in low RAM */
+#ifdef HOST
+/* host build (see host/c80.c) */
+static char **ckptr = &hostckp;
+#else
 static char **ckptr = 0x009;
+#endif
 
 /* Operating System name and version used to activate
 ** appropriate OS-specific function calls
@@ -73,6 +78,13 @@ EXTERN int osver;
 #define OSCPM   2
 #define OSMPM   3
 
+/* unit in which local files grow */
+#ifdef HDOS
+#define GROWSZ  256     /* HDOS sector */
+#else
+#define GROWSZ  128     /* CP/M record */
+#endif
+
 /********************************************************
 **
 ** OS-specific timer definitions
@@ -104,12 +116,26 @@ struct scbstruct {
         int     value;
 };
 
+/* a list of file names, stored one after the other as
+** NUL-terminated strings in nl_buf (see vnladd())
+*/
+struct vnlist {
+        char    *nl_buf;
+        int     nl_size;        /* bytes in nl_buf */
+        int     nl_len;         /* bytes used */
+        int     nl_n;           /* number of names */
+};
+
 /* MP/M BDOS function -Get System Data Area */
 #define GETSDA  0x9A
 
 /* 2ms. "tick" counter style clock is used only for
 ** CP/M 2.2 and HDOS short time duration measurements
 */
+#ifdef HOST
+/* host build - kept by the simulator (host/vsim.c) */
+#define TICCNT  (&hosttic)
+#else
 #ifdef HDOS
 /* HDOS TICCNT = 040.033A */
 #define TICCNT  0x201B
@@ -117,6 +143,7 @@ struct scbstruct {
 /* CP/M 2.2 puts it in low RAM */
 #define TICCNT  0x000B
 #endif
+#endif
 
 /* if file PFILE exists it contains an optional
 ** port number to be used.
@@ -136,17 +163,28 @@ int hexval();
 int hexcat();
 int commafmt();
 int aotoi();
+long dectol();
+char *ltodec();
+char *ltotenth();
+int lseekl();
 
 /* string functions */
 int strrchr();
 char *strncpy();
 int strupr();
 int isprint();
+int wcmatch();
+int iswild();
+int vnlinit();
+int vnladd();
 
 /* time and date */
 int modays();
 int is_leap();
 int timer();
+char *secclk();
+long ticks();
+int tickhz();
 int settd();
 int dodate();
 int prndate();